@@ -1,45 +1,233 @@
+#include "BitFrontierBFS.h"
+#include "Neighborhood.h"
+#include "TraversalStats.h"
+#include "TraversalWorkspace.h"
+#include "Parallel.h"
+
 class Solution {
 private:
+    // Same multi-source BFS, on the flat Grid: neighbours are index offsets
+    // and the 0-sentinel border means no bounds checks.
+    // A cell is set to 0 in mat as it is pushed, so it is never pushed again
+    // and its first distance (BFS order) is final: no min() needed.
+    void bfs(Grid<int>& mat, Grid<int>& dist) {
+        STAT_SCOPE("updateMatrix bfs");
+        withFrontier(mat.cells.size(), [&](auto& q) {
+            for (int i = 0; i < mat.rows; i++) {
+                for (int j = 0; j < mat.cols; j++) {
+                    if (mat(i, j) == 0) {
+                        q.push(mat.index(i, j));
+                    }
+                }
+            }
+
+            gridBfs<Four>(mat, q,
+                [&](long long np) { return mat[np] == 1; },
+                [&](long long np, long long p) {
+                    dist[np] = dist[p] + 1;
+                    mat[np] = 0;
+                    return false;
+                });
+        });
+    }
+
+    // Old signature, kept as a thin adapter over the Grid version.
     void bfs(vector<vector<int>>& mat, vector<vector<int>>& dist) {
-        queue<pair<int, int>> q;
-        int row = mat.size(), col = mat[0].size();
+        Grid<int> g = Grid<int>::from(mat, 0);
+        Grid<int> d = Grid<int>::from(dist, 0);
+        bfs(g, d);
+        g.copyTo(mat);
+        d.copyTo(dist);
+    }
+
+public:
+    Grid<int> updateMatrix(Grid<int>& mat) {
+        Grid<int> dist(mat.rows, mat.cols, 0, 0, mat.pad);
+        bfs(mat, dist);
+        return dist;
+    }
+
+    vector<vector<int>> updateMatrix(vector<vector<int>>& mat) {
+        Grid<int> g = Grid<int>::from(mat, 0);
+        Grid<int> dist = updateMatrix(g);
+        g.copyTo(mat);
+        return dist.toVector();
+    }
 
-        for (int i = 0; i < row; i++) {
-            for (int j = 0; j < col; j++) {
-                if (mat[i][j] == 0) {
-                    q.push({i, j});
+    // For many queries: dist must already have mat's shape (and pad). mat is
+    // left untouched — visited cells live in the workspace's epoch-stamped
+    // set — and the queue is reused, so a steady-state call allocates nothing.
+    // Every cell of dist is written; with no 0 in mat the result is all 0s.
+    void updateMatrix(const Grid<int>& mat, Grid<int>& dist, TraversalWorkspace& ws) {
+        STAT_SCOPE("updateMatrix");
+        ws.seen.reset(mat.cells.size());
+        ws.frontier(mat.cells.size(), [&](auto& q) {
+            for (int i = 0; i < mat.rows; i++) {
+                for (int j = 0; j < mat.cols; j++) {
+                    long long id = mat.index(i, j);
+                    dist[id] = 0; // cells the BFS never reaches stay 0, as in the original
+                    if (mat[id] == 0) {
+                        ws.seen.insert(id);
+                        q.push(id);
+                    }
                 }
             }
+            gridBfs<Four>(mat, q,
+                [&](long long np) { return mat[np] == 1 && !ws.seen.contains(np); },
+                [&](long long np, long long p) {
+                    ws.seen.insert(np);
+                    dist[np] = dist[p] + 1;
+                    return false;
+                });
+        });
+    }
+};
+
+/*
+Distance transform (raster passes, no queue, does not touch mat)
+
+Manhattan distance is separable:
+    dist(r, c) = min over rows r' of ( |r - r'| + rowDist(r', c) )
+where rowDist is the distance to the nearest 0 inside the same row.
+Step 1: rowDist for every row with one left→right and one right→left pass.
+        Rows are independent → split between threads.
+Step 2: one top→bottom and one bottom→top pass:
+        d[r][c] = min(d[r][c], d[r∓1][c] + 1).
+        Each step is a whole row at once (min/add over contiguous ints, the
+        compiler vectorizes it), and columns are split between threads.
+No queue and no pair<int,int>: 4 streaming passes over memory.
+If mat has no 0 at all, every cell gets a value >= rows + cols (exactly
+rows + cols for the Euclidean one); an empty mat gives an empty result.
+
+Exact Euclidean distance (Felzenszwalb–Huttenlocher):
+Step 1: g = vertical distance to the nearest 0 in the same column (same
+        down/up passes as above, columns split between threads).
+Step 2: for each row, dist²(c) = min over q of (c - q)² + g(q)²: the lower
+        envelope of parabolas, built in one left→right sweep. Rows are
+        independent → split between threads.
+Both are O(rows × cols).
+*/
+Grid<int> manhattanDistanceTransform(const Grid<int>& mat, int threads = thread::hardware_concurrency()) {
+    int n = mat.rows, m = mat.cols, INF = n + m;
+    Grid<int> dist(n, m, 0, 0, mat.pad); // same stride as mat
+
+    // Step 1: along each row
+    parallelFor(n, threads, [&](long long r0, long long r1) {
+        for (int r = r0; r < r1; r++) {
+            const int* in = &mat.cells[mat.index(r, 0)];
+            int* d = &dist.cells[dist.index(r, 0)];
+            int cur = INF;
+            for (int c = 0; c < m; c++) {
+                cur = in[c] == 0 ? 0 : cur + 1;
+                d[c] = cur;
+            }
+            cur = INF;
+            for (int c = m - 1; c >= 0; c--) {
+                cur = min(cur + 1, d[c]);
+                d[c] = cur;
+            }
+        }
+    });
+
+    // Step 2: down and up, one full row slice at a time
+    parallelFor(m, threads, [&](long long c0, long long c1) {
+        for (int r = 1; r < n; r++) {
+            int* d = &dist.cells[dist.index(r, 0)];
+            const int* up = d - dist.stride;
+            for (int c = c0; c < c1; c++) d[c] = min(d[c], up[c] + 1);
         }
+        for (int r = n - 2; r >= 0; r--) {
+            int* d = &dist.cells[dist.index(r, 0)];
+            const int* down = d + dist.stride;
+            for (int c = c0; c < c1; c++) d[c] = min(d[c], down[c] + 1);
+        }
+    });
+    return dist;
+}
 
-        vector<pair<int, int>> dirs = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+Grid<double> euclideanDistanceTransform(const Grid<int>& mat, int threads = thread::hardware_concurrency()) {
+    int n = mat.rows, m = mat.cols;
+    long long INF = n + m;
+    Grid<long long> g(n, m, 0, 0, mat.pad);
+    Grid<double> dist(n, m, 0, 0, mat.pad);
+    if (n == 0 || m == 0) return dist; // the envelope below needs one column
 
-        while (!q.empty()) {
-            pair<int, int> p = q.front();
-            q.pop();
+    // Step 1: vertical distance to the nearest 0 in each column
+    parallelFor(m, threads, [&](long long c0, long long c1) {
+        for (int r = 0; r < n; r++) {
+            const int* in = &mat.cells[mat.index(r, 0)];
+            long long* d = &g.cells[g.index(r, 0)];
+            const long long* up = d - g.stride;
+            for (int c = c0; c < c1; c++) d[c] = in[c] == 0 ? 0 : (r ? up[c] + 1 : INF);
+        }
+        for (int r = n - 2; r >= 0; r--) {
+            long long* d = &g.cells[g.index(r, 0)];
+            const long long* down = d + g.stride;
+            for (int c = c0; c < c1; c++) d[c] = min(d[c], down[c] + 1);
+        }
+    });
 
-            for (auto dir : dirs) {
-                int r = p.first, c = p.second, dr = dir.first, dc = dir.second;
-                int nr = r + dr, nc = c + dc;
+    // Step 2: lower envelope of parabolas along each row
+    parallelFor(n, threads, [&](long long r0, long long r1) {
+        vector<long long> f(m);
+        vector<int> v(m);          // columns of the parabolas in the envelope
+        vector<double> z(m + 1);   // where parabola k takes over from k-1
+        for (int r = r0; r < r1; r++) {
+            bool any = false;
+            for (int c = 0; c < m; c++) {
+                f[c] = g(r, c) * g(r, c);
+                any |= g(r, c) < INF;
+            }
+            // no 0 in any column means no 0 anywhere: nothing to build
+            if (!any) {
+                for (int c = 0; c < m; c++) dist(r, c) = INF;
+                continue;
+            }
+            auto meet = [&](long long q, long long p) {
+                return ((f[q] + q * q) - (f[p] + p * p)) / (2.0 * (q - p));
+            };
 
-                if (nr >= 0 && nr < mat.size() && nc >= 0 &&
-                    nc < mat[0].size() && mat[nr][nc] == 1) {
-                    if (dist[nr][nc] != 0)
-                        dist[nr][nc] = min(dist[nr][nc], dist[r][c] + 1);
-                    else
-                        dist[nr][nc] = dist[r][c] + 1;
-                    q.push({nr, nc});
-                    mat[nr][nc] = 0;
+            int k = 0;
+            v[0] = 0;
+            z[0] = -INFINITY;
+            z[1] = INFINITY;
+            for (int q = 1; q < m; q++) {
+                double s = meet(q, v[k]);
+                while (s <= z[k]) {
+                    k--;
+                    s = meet(q, v[k]);
                 }
+                k++;
+                v[k] = q;
+                z[k] = s;
+                z[k + 1] = INFINITY;
+            }
+
+            k = 0;
+            for (int q = 0; q < m; q++) {
+                while (z[k + 1] < q) k++;
+                long long dq = q - v[k];
+                dist(r, q) = sqrt((double)(dq * dq + f[v[k]]));
             }
         }
-    }
+    });
+    return dist;
+}
 
-public:
-    vector<vector<int>> updateMatrix(vector<vector<int>>& mat) {
-        int row = mat.size(), col = mat[0].size();
-        vector<vector<int>> dist(row, vector<int>(col, 0));
-        bfs(mat, dist);
-        return dist;
-    }
-};
+// Non-destructive replacement for updateMatrix: mat is only read.
+vector<vector<int>> updateMatrixTransform(const vector<vector<int>>& mat) {
+    Grid<int> g = Grid<int>::from(mat, 0);
+    return manhattanDistanceTransform(g).toVector();
+}
+
+// Same multi-source spread on bitsets: every 0 is a source, level k of the
+// BitFrontierBFS is exactly the set of cells at distance k.
+Grid<int> updateMatrixBitset(const Grid<int>& mat) {
+    STAT_SCOPE("updateMatrixBitset");
+    BitGrid ones = BitGrid::from(mat, 1);
+    BitGrid zeros = BitGrid::from(mat, 0);
+    BitFrontierBFS bfs(ones, zeros);
+    Grid<int> dist(mat.rows, mat.cols, 0, 0, mat.pad);
+    while (bfs.step()) bfs.forEachFrontier([&](int r, int c) { dist(r, c) = bfs.level(); });
+    return dist;
+}
@@ -0,0 +1,147 @@
+#pragma once
+#include "BitGrid.h"
+#include "TraversalStats.h"
+
+/*
+BitFrontierBFS — level-synchronous multi-source BFS with bitset frontiers
+
+Rotting oranges and 01 Matrix are both "spread one step per minute from
+many sources" problems. A queue of pair<int,int> pays one push/pop per cell.
+Here the cells already reached (visited) and the cells that may be entered
+(open) are BitGrids, 1 bit per cell; the current level (frontier) is a
+BitGrid too while it is large, and a list of cells while it is small.
+
+Each step() builds the next level in one of two ways:
+- Top-down (frontier is small): the frontier is a plain list of cells;
+  walk it and try their 4 neighbours — like a normal BFS. Only the list
+  and the visited bits of the new cells are touched, so a level costs
+  ~ frontier size, even on a grid of a billion cells.
+- Bottom-up (frontier is big): the frontier is a BitGrid, and for every
+  64-cell word ask "which still unvisited open cells have a neighbour in
+  the frontier?":
+      next = open & ~visited & (F << 1 | F >> 1 | F(row above) | F(row below))
+  (with the carry bits between neighbouring words). A whole minute becomes
+  a few shifted AND/OR word operations, cost ~ grid size / 64.
+step() picks bottom-up when frontier cells * 32 >= words in the grid. Only
+when the choice changes is the frontier converted between list and bitset;
+that costs ~ grid size / 64 once, no more than one bottom-up level.
+Read the frontier with forEachFrontier(f), which uses whichever form it is in.
+*/
+
+class BitFrontierBFS {
+public:
+    // `open` is kept by reference and must outlive the engine.
+    BitFrontierBFS(const BitGrid& open, const BitGrid& sources)
+        : open(open), vis(sources), cur(sources), next(open.rows, open.cols) {
+        curCount = cur.count();
+        STAT_ENQUEUE(curCount, curCount);
+    }
+
+    // Advance one level. Returns false (and reaches nothing) if no new cell
+    // was reached.
+    bool step() {
+        STAT_LEVEL();
+        STAT_VISIT(curCount); // the frontier is expanded
+        long long words = next.bits.size();
+        lastBottomUp = curCount * 32 >= words;
+        if (lastBottomUp && asList) toBits();
+        if (!lastBottomUp && !asList) toList();
+        long long found = lastBottomUp ? bottomUp() : topDown();
+        STAT_LEVEL_END();
+        STAT_ENQUEUE(found, found);
+        if (!found) return false;
+        if (lastBottomUp) swap(cur, next);
+        else swap(curList, nextList);
+        curCount = found;
+        levels++;
+        return true;
+    }
+
+    // f(r, c) for every cell of the current frontier (the last level reached).
+    template <class F>
+    void forEachFrontier(F f) const {
+        if (asList) {
+            for (long long cell : curList) f(int(cell >> 32), int(cell & 0xFFFFFFFF));
+            return;
+        }
+        for (int r = 0; r < cur.rows; r++)
+            for (int k = 0; k < cur.words; k++)
+                for (uint64_t bits = cur.row(r)[k]; bits; bits &= bits - 1) f(r, k * 64 + __builtin_ctzll(bits));
+    }
+    const BitGrid& visited() const { return vis; }
+    long long frontierCount() const { return curCount; }
+    int level() const { return levels; }
+    bool lastStepBottomUp() const { return lastBottomUp; }
+
+    // Open cells that were never reached.
+    long long unreached() const {
+        long long total = 0;
+        for (size_t k = 0; k < open.bits.size(); k++)
+            total += __builtin_popcountll(open.bits[k] & ~vis.bits[k]);
+        return total;
+    }
+
+private:
+    const BitGrid& open;
+    BitGrid vis, cur, next;             // cur / next: the frontier as bits (bottom-up)
+    vector<long long> curList, nextList; // ... or as cells r << 32 | c (top-down)
+    bool asList = false;                // which of the two holds the frontier
+    long long curCount = 0;
+    int levels = 0;
+    bool lastBottomUp = false;
+
+    void toList() {
+        curList.clear();
+        forEachFrontier([&](int r, int c) { curList.push_back((long long)r << 32 | c); });
+        asList = true;
+    }
+    void toBits() {
+        fill(cur.bits.begin(), cur.bits.end(), 0);
+        for (long long cell : curList) cur.set(int(cell >> 32), int(cell & 0xFFFFFFFF));
+        asList = false;
+    }
+
+    long long topDown() {
+        nextList.clear();
+        auto visit = [&](int r, int c) {
+            if (open.get(r, c) && !vis.get(r, c)) {
+                vis.set(r, c);
+                nextList.push_back((long long)r << 32 | c);
+            }
+        };
+        for (long long cell : curList) {
+            int r = int(cell >> 32), c = int(cell & 0xFFFFFFFF);
+            if (r > 0) visit(r - 1, c);
+            if (r + 1 < vis.rows) visit(r + 1, c);
+            if (c > 0) visit(r, c - 1);
+            if (c + 1 < vis.cols) visit(r, c + 1);
+        }
+        return nextList.size();
+    }
+
+    // Writes every word of next, so next needs no clearing first.
+    long long bottomUp() {
+        long long found = 0;
+        int W = cur.words;
+        for (int r = 0; r < cur.rows; r++) {
+            const uint64_t* f = cur.row(r);
+            const uint64_t* up = r > 0 ? cur.row(r - 1) : nullptr;
+            const uint64_t* down = r + 1 < cur.rows ? cur.row(r + 1) : nullptr;
+            const uint64_t* o = open.row(r);
+            uint64_t* v = vis.row(r);
+            uint64_t* n = next.row(r);
+            for (int k = 0; k < W; k++) {
+                uint64_t nb = f[k] << 1 | f[k] >> 1;
+                if (k > 0) nb |= f[k - 1] >> 63;
+                if (k + 1 < W) nb |= f[k + 1] << 63;
+                if (up) nb |= up[k];
+                if (down) nb |= down[k];
+                uint64_t add = nb & o[k] & ~v[k];
+                n[k] = add;
+                v[k] |= add;
+                found += __builtin_popcountll(add);
+            }
+        }
+        return found;
+    }
+};
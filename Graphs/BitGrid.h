@@ -0,0 +1,82 @@
+#pragma once
+#include "Grid.h"
+
+/*
+BitGrid — a binary (land/water, open/blocked) grid with 1 bit per cell
+
+A vector<vector<char>> grid spends a byte per cell, plus another int per cell
+for `vis`. Here 64 cells share one uint64_t, so a whole row of 20k cells is
+only ~2.5 KB and algorithms can look at 64 cells in a single operation
+(find the next land cell, skip a long stretch of water, AND two rows...).
+
+Layout:
+Row r occupies words [r * words, (r + 1) * words), bit c % 64 of word c / 64
+is cell (r, c). Bits past `cols` in the last word of a row are always 0.
+*/
+
+struct BitGrid {
+    int rows = 0, cols = 0, words = 0; // words = 64-bit words per row
+    CellStore<uint64_t> bits; // can also be a mapped file, see GridFile.h
+
+    BitGrid() {}
+    BitGrid(int rows, int cols)
+        : rows(rows), cols(cols), words((cols + 63) / 64), bits((long long)rows * words, 0) {}
+
+    template <class T>
+    static BitGrid from(const vector<vector<T>>& v, T one) {
+        int n = v.size(), m = n ? v[0].size() : 0;
+        BitGrid g(n, m);
+        for (int r = 0; r < n; r++)
+            for (int c = 0; c < m; c++)
+                if (v[r][c] == one) g.set(r, c);
+        return g;
+    }
+
+    template <class T>
+    static BitGrid from(const Grid<T>& v, T one) {
+        BitGrid g(v.rows, v.cols);
+        for (int r = 0; r < v.rows; r++)
+            for (int c = 0; c < v.cols; c++)
+                if (v(r, c) == one) g.set(r, c);
+        return g;
+    }
+
+    uint64_t* row(int r) { return bits.data() + (long long)r * words; }
+    const uint64_t* row(int r) const { return bits.data() + (long long)r * words; }
+
+    bool get(int r, int c) const { return row(r)[c >> 6] >> (c & 63) & 1; }
+    void set(int r, int c) { row(r)[c >> 6] |= 1ULL << (c & 63); }
+    void reset(int r, int c) { row(r)[c >> 6] &= ~(1ULL << (c & 63)); }
+
+    long long count() const {
+        long long total = 0;
+        for (uint64_t w : bits) total += __builtin_popcountll(w);
+        return total;
+    }
+
+    // First set / clear cell at column >= c in row r, or cols if there is none.
+    // Both jump over 64 cells at a time.
+    int nextSet(int r, int c) const {
+        const uint64_t* w = row(r);
+        if (c >= cols) return cols;
+        int k = c >> 6;
+        uint64_t cur = w[k] & (~0ULL << (c & 63));
+        while (!cur) {
+            if (++k == words) return cols;
+            cur = w[k];
+        }
+        return k * 64 + __builtin_ctzll(cur);
+    }
+
+    int nextClear(int r, int c) const {
+        const uint64_t* w = row(r);
+        if (c >= cols) return cols;
+        int k = c >> 6;
+        uint64_t cur = ~w[k] & (~0ULL << (c & 63));
+        while (!cur) {
+            if (++k == words) return cols;
+            cur = ~w[k];
+        }
+        return min(cols, k * 64 + __builtin_ctzll(cur));
+    }
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include <bits/stdc++.h>
+using namespace std;
+
+/*
+ConcurrentDSU — union-find that many threads can use at the same time, no locks
+
+The normal DSU (NumberofIslands.cpp / FloodFill.cpp) is not thread-safe:
+recursive path compression and union by size both write several cells that
+another thread might be reading.
+
+Here every parent is an atomic<int> and the structure keeps one invariant:
+parent[x] <= x (a node only ever points to a smaller index).
+
+find  — path halving: x -> parent[x] -> grandparent; each step tries to
+        point x at its grandparent with a CAS. If the CAS loses a race it
+        does not matter, the pointer only ever moves to a smaller index.
+unite — union by index: find both roots and CAS the larger root to point at
+        the smaller one. The CAS only succeeds if that node is still a root;
+        if another thread linked it first, just retry.
+Because links always go from larger to smaller index, no cycle can appear.
+unite returns true only for the thread whose CAS actually merged two sets,
+so counting true results gives the exact number of merges.
+*/
+
+struct ConcurrentDSU {
+    int n;
+    unique_ptr<atomic<int>[]> parent;
+
+    explicit ConcurrentDSU(int n) : n(n), parent(new atomic<int>[n]) {
+        for (int i = 0; i < n; i++) parent[i].store(i, memory_order_relaxed);
+    }
+
+    int find(int x) {
+        while (true) {
+            int p = parent[x].load(memory_order_relaxed);
+            if (p == x) return x;
+            int gp = parent[p].load(memory_order_relaxed);
+            if (p != gp) parent[x].compare_exchange_weak(p, gp, memory_order_relaxed);
+            x = gp;
+        }
+    }
+
+    bool unite(int a, int b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return false;
+            if (a < b) swap(a, b);
+            int expected = a;
+            if (parent[a].compare_exchange_strong(expected, b, memory_order_acq_rel)) return true;
+        }
+    }
+
+    bool same(int a, int b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return true;
+            // a was a root when we found it; if it still is, they really differ
+            if (parent[a].load(memory_order_acquire) == a) return false;
+        }
+    }
+};
@@ -26,60 +26,72 @@ Remove redundant boundary checks like p.first + 1 >= 0 — BFS never produces ne
 Remove repeated color != prevColor checks inside BFS — you can just check once at the start.
 
 */
-#include <bits/stdc++.h>
-using namespace std;
-
-void bfsFloodFill(int sr, int sc, vector<vector<int>>& image, int newColor) {
-    int prevColor = image[sr][sc];
+#include "Grid.h"
+#include "ConcurrentDSU.h"
+#include "GridFile.h"
+#include "Neighborhood.h"
+#include "Parallel.h"
+#include "TiledGrid.h"
+#include "TraversalStats.h"
+#include "TraversalWorkspace.h"
+
+// The queue comes from the workspace, so repeated fills allocate nothing
+// (the recolouring itself is the visited mark). Image is a Grid<int> or a
+// TiledGrid<int> (TiledGrid.h).
+template <class Image>
+void bfsFloodFill(int sr, int sc, Image& image, int newColor, TraversalWorkspace& ws) {
+    STAT_SCOPE("bfsFloodFill");
+    long long start = image.index(sr, sc);
+    int prevColor = image[start];
     if (prevColor == newColor) return; // no need to do anything
+    if (prevColor == image.sentinel) return; // sentinel must never be a real colour
+
+    ws.frontier(image.cells.size(), [&](auto& q) {
+        q.push(start);
+        image[start] = newColor;
+
+        // directions: up, down, left, right
+        // The border holds the sentinel, so only the colour check is needed.
+        // Recolouring on push keeps every cell in the queue at most once.
+        gridBfs<Four>(image, q,
+            [&](long long nxt) { return image[nxt] == prevColor; },
+            [&](long long nxt, long long) { image[nxt] = newColor; return false; }); // Recolor the cell
+    });
+}
 
-    int rows = image.size();
-    int cols = image[0].size();
-
-    queue<pair<int, int>> q;
-    q.push({sr, sc});
-    image[sr][sc] = newColor;
-
-    // directions: up, down, left, right
-    vector<pair<int, int>> dirs = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
-
-    while (!q.empty()) {
-        pair<int, int> cell = q.front();
-        q.pop();
-        int r = cell.first;
-        int c = cell.second;
-
-        for (int i = 0; i < dirs.size(); i++) {
-            int dr = dirs[i].first;
-            int dc = dirs[i].second;
-
-            int nr = r + dr;
-            int nc = c + dc;
-
-            // Check bounds and whether the color matches
-            if (nr >= 0 && nr < rows && nc >= 0 && nc < cols && image[nr][nc] == prevColor) {
-                image[nr][nc] = newColor; // Recolor the cell
-                q.push({nr, nc});        // Push into the BFS queue
-            }
-        }
-    }
+void bfsFloodFill(int sr, int sc, Grid<int>& image, int newColor) {
+    TraversalWorkspace ws;
+    bfsFloodFill(sr, sc, image, newColor, ws);
+}
 
+// Old signature, kept as a thin adapter over the Grid version.
+void bfsFloodFill(int sr, int sc, vector<vector<int>>& image, int newColor) {
+    Grid<int> g = Grid<int>::from(image, INT_MIN);
+    bfsFloodFill(sr, sc, g, newColor);
+    g.copyTo(image);
 }
 
-int main() {
+// Usage: ./floodfill [grid file]   (CellEncoding::Int, sentinel INT_MIN)
+int main(int argc, char** argv) {
     vector<vector<int>> image = {
         {1,1,1},
         {1,1,0},
         {1,0,1}
     };
 
+    Grid<int> g = Grid<int>::from(image, INT_MIN);
+    if (argc > 1 && !mapGrid(argv[1], g, INT_MIN)) {
+        cerr << "cannot read grid file " << argv[1] << '\n';
+        return 1;
+    }
+
     int sr, sc, color;
     cin >> sr >> sc >> color;
 
-    bfsFloodFill(sr, sc, image, color);
+    bfsFloodFill(sr, sc, g, color);
 
-    for (auto &row : image) {
-        for (auto &val : row) cout << val << ' ';
+    for (int r = 0; r < g.rows; r++) {
+        for (int c = 0; c < g.cols; c++) cout << g(r, c) << ' ';
         cout << '\n';
     }
 
@@ -126,7 +138,8 @@ Since we are changing the color directly in the image, no need for a separate vi
 Connected Component Labeling (Union-Find)
 Overkill for flood fill, but possible:
 First, find all connected cells with the original color using Union-Find (Disjoint Set Union), then recolor them.
-Useful if you want to do many flood fills on the same image efficiently.
+Useful if you want to do many flood fills on the same image efficiently —
+RegionIndex (further down) labels once and keeps the labels up to date.
 */
 
 // DFS Recursive Approach
@@ -186,44 +199,263 @@ struct DSU {
     }
 };
 
+void unionFindFloodFill(Grid<int>& image, int sr, int sc, int newColor) {
+    int prevColor = image(sr, sc);
+    if (prevColor == newColor || prevColor == image.sentinel) return;
+    DSU dsu(image.cells.size());
+
+    // Step 1: Union all connected same-color cells
+    // (looking up and left is enough to see every edge once)
+    long long up = -image.stride, left = -1;
+    for (int r = 0; r < image.rows; r++) {
+        for (int c = 0; c < image.cols; c++) {
+            long long id = image.index(r, c);
+            if (image[id] != prevColor) continue;
+            if (image[id + up] == prevColor) dsu.unite(id, id + up);
+            if (image[id + left] == prevColor) dsu.unite(id, id + left);
+        }
+    }
+
+    // Step 2: Recolor all cells in the same component as start
+    int comp = dsu.find(image.index(sr, sc));
+    for (int r = 0; r < image.rows; r++) {
+        for (int c = 0; c < image.cols; c++) {
+            long long id = image.index(r, c);
+            if (dsu.find(id) == comp) {
+                image[id] = newColor;
+            }
+        }
+    }
+}
+
 void unionFindFloodFill(vector<vector<int>>& image, int sr, int sc, int newColor) {
-    int prevColor = image[sr][sc];
-    if (prevColor == newColor) return;
-    int rows = image.size(), cols = image[0].size();
-    DSU dsu(rows * cols);
+    Grid<int> g = Grid<int>::from(image, INT_MIN);
+    unionFindFloodFill(g, sr, sc, newColor);
+    g.copyTo(image);
+}
 
-    auto idx = [&](int r, int c) { return r * cols + c; };
-    vector<pair<int,int>> dirs = {{-1,0}, {1,0}, {0,-1}, {0,1}};
+// Same Union-Find idea, but the union and recolor phases run on several
+// threads sharing one lock-free ConcurrentDSU.
+void unionFindFloodFillParallel(Grid<int>& image, int sr, int sc, int newColor,
+                                int threads = thread::hardware_concurrency()) {
+    int prevColor = image(sr, sc);
+    if (prevColor == newColor || prevColor == image.sentinel) return;
+    ConcurrentDSU dsu(image.cells.size());
+    long long up = -image.stride, left = -1;
+
+    // Step 1: Union all connected same-color cells, rows split between threads
+    parallelFor(image.rows, threads, [&](long long r0, long long r1) {
+        for (int r = r0; r < r1; r++) {
+            for (int c = 0; c < image.cols; c++) {
+                long long id = image.index(r, c);
+                if (image[id] != prevColor) continue;
+                if (image[id + up] == prevColor) dsu.unite(id, id + up);
+                if (image[id + left] == prevColor) dsu.unite(id, id + left);
+            }
+        }
+    });
+
+    // Step 2: Recolor (find is safe to call from every thread)
+    int comp = dsu.find(image.index(sr, sc));
+    parallelFor(image.rows, threads, [&](long long r0, long long r1) {
+        for (int r = r0; r < r1; r++) {
+            for (int c = 0; c < image.cols; c++) {
+                long long id = image.index(r, c);
+                if (image[id] == prevColor && dsu.find(id) == comp) image[id] = newColor;
+            }
+        }
+    });
+}
 
-    // Step 1: Union all connected same-color cells
-    for (int r = 0; r < rows; r++) {
-        for (int c = 0; c < cols; c++) {
-            if (image[r][c] == prevColor) {
-                for (size_t k = 0; k < dirs.size(); k++) {
-                    int dr = dirs[k].first;
-                    int dc = dirs[k].second;
-                    int nr = r + dr;
-                    int nc = c + dc;
-
-                    if (nr >= 0 && nr < rows && nc >= 0 && nc < cols &&
-                        image[nr][nc] == prevColor) {
-                        dsu.unite(idx(r, c), idx(nr, nc));
-                    }
+/*
+Scanline (Span) Approach
+BFS/DFS push one (r, c) per pixel, so a 100-megapixel fill needs a queue
+or stack with up to 100M entries (and the recursive DFS overflows long before).
+Instead, paint whole horizontal runs at once:
+Step 1: Pop a seed and grow it left and right while the colour is prevColor
+(the sentinel border stops it at the image edge).
+Step 2: Fill that whole span.
+Step 3: Walk the rows just above and below the span and push only ONE seed
+for each run of prevColor found there.
+The stack now holds span seeds, not pixels: memory ~ number of spans.
+Same signature as bfsFloodFill, so it can be swapped in directly.
+*/
+void scanlineFloodFill(int sr, int sc, Grid<int>& image, int newColor, TraversalWorkspace& ws) {
+    STAT_SCOPE("scanlineFloodFill");
+    long long start = image.index(sr, sc);
+    int prevColor = image[start];
+    if (prevColor == newColor || prevColor == image.sentinel) return;
+
+    vector<long long>& seeds = ws.lifo; // reused stack of span seeds
+    seeds.assign(1, start);
+    STAT_ENQUEUE(1, 1);
+
+    while (!seeds.empty()) {
+        long long seed = seeds.back();
+        seeds.pop_back();
+        if (image[seed] != prevColor) continue; // already painted by another span
+
+        // Step 1: grow the span
+        long long l = seed, r = seed;
+        while (image[l - 1] == prevColor) l--;
+        while (image[r + 1] == prevColor) r++;
+        STAT_VISIT(r - l + 1); // every pixel of the span
+
+        // Step 2: paint it
+        fill(image.cells.begin() + l, image.cells.begin() + r + 1, newColor);
+
+        // Step 3: one seed per run in the row above and the row below
+        for (long long nb : {-image.stride, image.stride}) {
+            bool inRun = false;
+            for (long long i = l; i <= r; i++) {
+                bool match = image[i + nb] == prevColor;
+                if (match && !inRun) {
+                    seeds.push_back(i + nb);
+                    STAT_ENQUEUE(1, seeds.size());
                 }
+                inRun = match;
             }
         }
     }
+}
 
-    // Step 2: Recolor all cells in the same component as start
-    int comp = dsu.find(idx(sr, sc));
-    for (int r = 0; r < rows; r++) {
-        for (int c = 0; c < cols; c++) {
-            if (dsu.find(idx(r, c)) == comp) {
-                image[r][c] = newColor;
+void scanlineFloodFill(int sr, int sc, Grid<int>& image, int newColor) {
+    TraversalWorkspace ws;
+    scanlineFloodFill(sr, sc, image, newColor, ws);
+}
+
+void scanlineFloodFill(int sr, int sc, vector<vector<int>>& image, int newColor) {
+    Grid<int> g = Grid<int>::from(image, INT_MIN);
+    scanlineFloodFill(sr, sc, g, newColor);
+    g.copyTo(image);
+}
+
+/*
+RegionIndex — label once, then answer many fills / region queries
+unionFindFloodFill rebuilds its DSU over the whole image on every call.
+When the same image gets many fills and "are these two pixels in the same
+region?" questions, label every color region ONCE and keep the labels up
+to date instead.
+
+Build (one pass, O(N α)):
+- Every row is cut into spans: maximal runs of one color. Each span is a
+  node, and label(r, c) is the span the pixel belongs to.
+- A span is united with the span above wherever the colors match (only
+  checked where the label above changes, so once per touching span pair).
+- Each region (DSU root) keeps its color, its size and a linked list of
+  its spans.
+
+Queries:
+- region(r, c) = find(label(r, c)), size / color are stored at the root.
+- recolor(r, c, newColor):
+  1. paint every span of the region (a fill() per span),
+  2. walk the region's boundary (the pixels left/right of each span and
+     above/below it): every neighbouring region that already has newColor
+     is united with it — the span lists are spliced in O(1), so nothing
+     else in the image is relabelled.
+  Cost ~ the pixels of the region, not of the image. The image ends up
+  exactly like after bfsFloodFill(r, c, image, newColor).
+Region ids are DSU roots, so an id can change when its region is merged.
+The index keeps a reference to `image` and is the only thing allowed to
+change it while the index is in use.
+*/
+class RegionIndex {
+public:
+    explicit RegionIndex(Grid<int>& image)
+        : image(image), label(image.rows, image.cols, -1, -1, image.pad) {
+        for (int r = 0; r < image.rows; r++) {
+            for (int c = 0; c < image.cols;) {
+                int end = c, id = spans.size();
+                while (end + 1 < image.cols && image(r, end + 1) == image(r, c)) end++;
+                spans.push_back({r, c, end, -1});
+                parent.push_back(id);
+                cells.push_back(end - c + 1);
+                head.push_back(id), tail.push_back(id), regionColor.push_back(image(r, c));
+                fill_n(label.cells.begin() + label.index(r, c), end - c + 1, id);
+                c = end + 1;
             }
         }
+        count = spans.size();
+        // unite with the row above, once per (span, span above) pair
+        for (int r = 1; r < image.rows; r++)
+            for (int c = 0; c < image.cols; c++)
+                if (image(r, c) == image(r - 1, c) &&
+                    (c == 0 || label(r - 1, c) != label(r - 1, c - 1) || label(r, c) != label(r, c - 1)))
+                    unite(label(r, c), label(r - 1, c));
     }
-}
+
+    int region(int r, int c) { return find(label(r, c)); }
+    bool sameRegion(int r1, int c1, int r2, int c2) { return region(r1, c1) == region(r2, c2); }
+    long long size(int region) const { return cells[region]; }
+    int color(int region) const { return regionColor[region]; }
+    int regionCount() const { return count; }
+
+    // Visit the spans (row, left, right) of a region.
+    template <class F>
+    void forEachSpan(int region, F f) const {
+        for (int s = head[region]; s != -1; s = spans[s].next) f(spans[s].row, spans[s].left, spans[s].right);
+    }
+
+    // Flood fill from (r, c). Returns the id of the (possibly merged) region.
+    int recolor(int r, int c, int newColor) {
+        int root = region(r, c);
+        if (regionColor[root] == newColor || newColor == image.sentinel) return root;
+
+        regionColor[root] = newColor;
+        forEachSpan(root, [&](int row, int left, int right) {
+            fill_n(image.cells.begin() + image.index(row, left), right - left + 1, newColor);
+        });
+
+        // neighbouring regions that already have newColor (sentinel border never matches)
+        touching.clear();
+        auto check = [&](long long id) {
+            if (image[id] == newColor) touching.push_back(label[id]);
+        };
+        forEachSpan(root, [&](int row, int left, int right) {
+            long long first = image.index(row, left), last = image.index(row, right);
+            check(first - 1);
+            check(last + 1);
+            for (long long id = first; id <= last; id++) {
+                check(id - image.stride);
+                check(id + image.stride);
+            }
+        });
+        for (int s : touching) root = unite(root, s);
+        return root;
+    }
+
+private:
+    struct Span {
+        int row, left, right;
+        int next; // next span of the same region, -1 at the end of the list
+    };
+
+    Grid<int>& image;
+    Grid<int> label; // span id of every pixel
+    vector<Span> spans;
+    vector<int> parent, head, tail, regionColor; // head / tail / regionColor are valid at roots
+    vector<long long> cells;                     // region size, valid at roots
+    vector<int> touching;                        // recolor() scratch, reused
+    int count = 0;
+
+    int find(int x) {
+        while (parent[x] != x) x = parent[x] = parent[parent[x]]; // path halving
+        return x;
+    }
+
+    // Union by size, splicing the smaller region's span list onto the larger.
+    int unite(int a, int b) {
+        a = find(a), b = find(b);
+        if (a == b) return a;
+        if (cells[a] < cells[b]) swap(a, b);
+        parent[b] = a;
+        cells[a] += cells[b];
+        spans[tail[a]].next = head[b];
+        tail[a] = tail[b];
+        count--;
+        return a;
+    }
+};
 
 /* This was my appraoch
 #include <bits/stdc++.h>
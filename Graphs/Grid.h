@@ -0,0 +1,140 @@
+#pragma once
+#include <bits/stdc++.h>
+using namespace std;
+
+/*
+Grid<T> — one flat, row-major block of memory for a 2D grid
+
+Why not vector<vector<T>>?
+Every row is its own heap allocation, so stepping to the cell above/below
+means following a different pointer. On a 20k x 20k grid that is 20k
+allocations and a cache miss on almost every vertical neighbour probe.
+
+Layout:
+All cells live in a single vector. The real grid is surrounded by a border
+of `pad` cells holding a sentinel value:
+
+    stride      = cols + 2*pad
+    index(r, c) = (r + pad) * stride + (c + pad)
+
+So the neighbour of cell i in direction (dr, dc) is just i + dr*stride + dc.
+Pick the sentinel so that no traversal ever accepts it (water, wall, a colour
+that never appears...). Then the usual
+    nr >= 0 && nr < n && nc >= 0 && nc < m
+check disappears from the hot loop — the border stops the search for free.
+
+pad = 1 is enough for 4/8-neighbour moves, knight moves need pad = 2.
+
+Storage:
+`cells` is a CellStore: it behaves like the vector it replaced (size, [],
+begin/end as plain pointers) but can also point at memory it does not own,
+e.g. a memory-mapped grid file (see GridFile.h), so a grid on disk is used
+in place without being copied. Copying a Grid always makes a private copy.
+*/
+
+template <class T>
+class CellStore {
+public:
+    CellStore() {}
+    CellStore(size_t n, const T& value) : own(n, value) { sync(); }
+    CellStore(const CellStore& o) : own(o.begin(), o.end()) { sync(); }
+    CellStore(CellStore&& o) noexcept { swap(o); }
+    CellStore& operator=(CellStore o) noexcept {
+        swap(o);
+        return *this;
+    }
+
+    // Use n cells at p without copying; `owner` keeps that memory alive
+    // (e.g. unmaps the file when the last copy of it goes away).
+    static CellStore borrow(T* p, size_t n, shared_ptr<void> owner) {
+        CellStore s;
+        s.ptr = p, s.count = n, s.owner = move(owner);
+        return s;
+    }
+
+    void swap(CellStore& o) noexcept {
+        own.swap(o.own);
+        std::swap(ptr, o.ptr);
+        std::swap(count, o.count);
+        owner.swap(o.owner);
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T* data() { return ptr; }
+    const T* data() const { return ptr; }
+    T* begin() { return ptr; }
+    T* end() { return ptr + count; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + count; }
+    T& operator[](size_t i) { return ptr[i]; }
+    const T& operator[](size_t i) const { return ptr[i]; }
+
+    bool operator==(const CellStore& o) const { return count == o.count && equal(begin(), end(), o.begin()); }
+    bool operator!=(const CellStore& o) const { return !(*this == o); }
+
+private:
+    vector<T> own;          // empty when borrowing
+    T* ptr = nullptr;
+    size_t count = 0;
+    shared_ptr<void> owner; // keeps borrowed memory alive
+
+    void sync() { ptr = own.data(), count = own.size(); }
+};
+
+template <class T>
+struct Grid {
+    int rows = 0, cols = 0, pad = 1;
+    long long stride = 0;
+    T sentinel{};
+    CellStore<T> cells;
+
+    Grid() {}
+
+    Grid(int rows, int cols, T fill, T sentinel, int pad = 1)
+        : rows(rows), cols(cols), pad(pad), stride(cols + 2LL * pad), sentinel(sentinel),
+          cells((rows + 2LL * pad) * (cols + 2LL * pad), sentinel) {
+        for (int r = 0; r < rows; r++)
+            fill_n(cells.begin() + index(r, 0), cols, fill);
+    }
+
+    // Adapter from the old vector<vector<T>> representation.
+    static Grid from(const vector<vector<T>>& v, T sentinel, int pad = 1) {
+        int n = v.size(), m = n ? v[0].size() : 0;
+        Grid g(n, m, sentinel, sentinel, pad);
+        for (int r = 0; r < n; r++)
+            copy(v[r].begin(), v[r].end(), g.cells.begin() + g.index(r, 0));
+        return g;
+    }
+
+    // Write the real cells back into a vector<vector<T>> of the same shape.
+    void copyTo(vector<vector<T>>& v) const {
+        for (int r = 0; r < rows; r++)
+            copy_n(cells.begin() + index(r, 0), cols, v[r].begin());
+    }
+
+    vector<vector<T>> toVector() const {
+        vector<vector<T>> v(rows, vector<T>(cols));
+        copyTo(v);
+        return v;
+    }
+
+    long long index(int r, int c) const { return (r + pad) * stride + (c + pad); }
+    int row(long long i) const { return i / stride - pad; }
+    int col(long long i) const { return i % stride - pad; }
+
+    T& operator[](long long i) { return cells[i]; }
+    const T& operator[](long long i) const { return cells[i]; }
+    T& operator()(int r, int c) { return cells[index(r, c)]; }
+    const T& operator()(int r, int c) const { return cells[index(r, c)]; }
+
+    // Index offsets for up, down, left, right.
+    array<long long, 4> dirs4() const { return {-stride, stride, -1, 1}; }
+
+    // Calls f(index) for every real cell, in memory order (row by row).
+    template <class F>
+    void forEachCell(F f) const {
+        for (int r = 0; r < rows; r++)
+            for (long long i = index(r, 0), end = i + cols; i < end; i++) f(i);
+    }
+};
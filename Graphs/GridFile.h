@@ -0,0 +1,310 @@
+#pragma once
+#include "BitGrid.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/*
+GridFile — a binary grid file that is used in place via mmap
+
+Reading a 1e9-cell grid with `cin >> x` parses a billion tokens before the
+algorithm even starts. A grid file instead stores the cells exactly as they
+sit in memory, so "loading" is one mmap() call and pages are read lazily by
+the first traversal that touches them.
+
+Layout (little-endian):
+    bytes 0..63   GridFileHeader (below, zero-filled to 64 bytes)
+    bytes 64..    the cells
+- Grid<T> files hold the whole padded Grid<T>.cells block (border included,
+  filled with the sentinel), so a mapped file IS a Grid<T>: index(), dirs4(),
+  the sentinel trick — everything works unchanged.
+- Bit-packed files hold BitGrid.bits (rows × words uint64_t, 1 bit per cell).
+
+mapGrid / mapBitGrid map the file MAP_PRIVATE: algorithms that write into
+the grid (flood fill, rotting oranges...) get copy-on-write pages and the
+file itself never changes. Both return false on a missing or malformed file.
+mapGrid also checks the border against what the caller's traversal relies
+on: the file's sentinel must be expectedSentinel (the value that blocks
+movement: '0' for islands, 0 for oranges and mazes, -1 for the knight
+board) and its width at least minPad (default 1; the knight's jumps need 2).
+
+Text grids (one row per line, one digit per cell, optional spaces / commas
+between cells) are turned into grid files by convertTextGrid():
+    CellEncoding::Char  1 byte per cell, the character itself ('0' / '1'),
+                        like NumberofIslands' Grid<char>
+    CellEncoding::Int   4 bytes per cell, the digit's value, Grid<int>
+    CellEncoding::Bits  1 bit per cell (digit != '0'), BitGrid
+Rows without separators (the common "0110..." form) are converted 32 bytes
+at a time with AVX2: one compare checks they are all digits, then a copy
+(Char), a widen-and-subtract (Int) or a movemask (Bits). Other rows, and
+builds without -mavx2, take the plain per-character loop.
+*/
+
+struct GridFileHeader {
+    char magic[8];       // "CQGRID" + format version
+    uint32_t cellBytes;  // sizeof(T); 8 (one word) when bit-packed
+    uint32_t flags;      // GridFileHeader::BitPacked
+    int32_t rows, cols, pad;
+    int32_t reserved;
+    int64_t sentinel;    // border value (Grid files only)
+    uint64_t dataOffset; // always 64
+    uint64_t dataBytes;
+
+    enum : uint32_t { BitPacked = 1 };
+    static constexpr char MAGIC[8] = {'C', 'Q', 'G', 'R', 'I', 'D', 0, 1};
+};
+
+enum class CellEncoding { Char, Int, Bits };
+
+namespace gridfile {
+
+const uint64_t DATA_OFFSET = 64;
+
+inline bool writeFile(const string& path, const GridFileHeader& h, const void* data) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    char head[DATA_OFFSET] = {};
+    memcpy(head, &h, sizeof(h));
+    bool ok = fwrite(head, 1, DATA_OFFSET, f) == DATA_OFFSET &&
+              fwrite(data, 1, h.dataBytes, f) == h.dataBytes;
+    return fclose(f) == 0 && ok;
+}
+
+inline GridFileHeader header(uint32_t cellBytes, uint32_t flags, int rows, int cols, int pad, int64_t sentinel,
+                             uint64_t dataBytes) {
+    GridFileHeader h{};
+    memcpy(h.magic, GridFileHeader::MAGIC, 8);
+    h.cellBytes = cellBytes, h.flags = flags;
+    h.rows = rows, h.cols = cols, h.pad = pad;
+    h.sentinel = sentinel;
+    h.dataOffset = DATA_OFFSET, h.dataBytes = dataBytes;
+    return h;
+}
+
+// mmap the whole file copy-on-write; the returned owner unmaps it.
+inline bool mapFile(const string& path, GridFileHeader& h, char*& base, shared_ptr<void>& owner) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < DATA_OFFSET) {
+        close(fd);
+        return false;
+    }
+    size_t length = st.st_size;
+    void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping stays valid
+    if (p == MAP_FAILED) return false;
+    memcpy(&h, p, sizeof(h));
+    if (memcmp(h.magic, GridFileHeader::MAGIC, 8) != 0 || h.dataOffset != DATA_OFFSET ||
+        h.dataOffset + h.dataBytes > length) {
+        munmap(p, length);
+        return false;
+    }
+    base = (char*)p;
+    owner = shared_ptr<void>(p, [length](void* q) { munmap(q, length); });
+    return true;
+}
+
+} // namespace gridfile
+
+template <class T>
+bool writeGrid(const string& path, const Grid<T>& g) {
+    static_assert(is_trivially_copyable<T>::value, "grid files hold raw cells");
+    return gridfile::writeFile(path,
+                               gridfile::header(sizeof(T), 0, g.rows, g.cols, g.pad, (int64_t)g.sentinel,
+                                                g.cells.size() * sizeof(T)),
+                               g.cells.data());
+}
+
+inline bool writeGrid(const string& path, const BitGrid& g) {
+    return gridfile::writeFile(path,
+                               gridfile::header(8, GridFileHeader::BitPacked, g.rows, g.cols, 0, 0,
+                                                g.bits.size() * 8),
+                               g.bits.data());
+}
+
+// Zero-copy: out.cells points straight into the mapped file.
+template <class T>
+bool mapGrid(const string& path, Grid<T>& out, T expectedSentinel, int minPad = 1) {
+    GridFileHeader h;
+    char* base;
+    shared_ptr<void> owner;
+    if (!gridfile::mapFile(path, h, base, owner)) return false;
+    long long stride = h.cols + 2LL * h.pad;
+    if ((h.flags & GridFileHeader::BitPacked) || h.cellBytes != sizeof(T) || h.pad < minPad ||
+        h.sentinel != (int64_t)expectedSentinel ||
+        h.dataBytes != (h.rows + 2ULL * h.pad) * stride * sizeof(T))
+        return false;
+    out.rows = h.rows, out.cols = h.cols, out.pad = h.pad, out.stride = stride;
+    out.sentinel = (T)h.sentinel;
+    out.cells = CellStore<T>::borrow((T*)(base + h.dataOffset), h.dataBytes / sizeof(T), move(owner));
+    return true;
+}
+
+inline bool mapBitGrid(const string& path, BitGrid& out) {
+    GridFileHeader h;
+    char* base;
+    shared_ptr<void> owner;
+    if (!gridfile::mapFile(path, h, base, owner)) return false;
+    int words = (h.cols + 63) / 64;
+    if (!(h.flags & GridFileHeader::BitPacked) || h.dataBytes != (uint64_t)h.rows * words * 8) return false;
+    out.rows = h.rows, out.cols = h.cols, out.words = words;
+    out.bits = CellStore<uint64_t>::borrow((uint64_t*)(base + h.dataOffset), h.dataBytes / 8, move(owner));
+    return true;
+}
+
+namespace gridfile {
+
+// Is every byte of [p, p + n) a digit? (AVX2: 32 bytes per compare)
+inline bool allDigits(const char* p, long long n) {
+    long long i = 0;
+#ifdef __AVX2__
+    const __m256i zero = _mm256_set1_epi8('0'), nine = _mm256_set1_epi8(9);
+    for (; i + 32 <= n; i += 32) {
+        __m256i d = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*)(p + i)), zero);
+        // unsigned d <= 9  <=>  max(d, 9) == 9
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(d, nine), nine)) != -1) return false;
+    }
+#endif
+    for (; i < n; i++)
+        if (p[i] < '0' || p[i] > '9') return false;
+    return true;
+}
+
+// Write n digit characters as cells. out points at the row's first cell
+// (Char / Int) or at the row's first word (Bits).
+inline void convertDense(const char* p, long long n, CellEncoding enc, void* out) {
+    long long i = 0;
+    if (enc == CellEncoding::Char) {
+        memcpy(out, p, n);
+    } else if (enc == CellEncoding::Int) {
+        int32_t* o = (int32_t*)out;
+#ifdef __AVX2__
+        const __m256i zero = _mm256_set1_epi32('0');
+        for (; i + 8 <= n; i += 8) {
+            __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(p + i)));
+            _mm256_storeu_si256((__m256i*)(o + i), _mm256_sub_epi32(v, zero));
+        }
+#endif
+        for (; i < n; i++) o[i] = p[i] - '0';
+    } else {
+        uint64_t* w = (uint64_t*)out;
+#ifdef __AVX2__
+        const __m256i zero = _mm256_set1_epi8('0');
+        for (; i + 32 <= n; i += 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+            uint64_t bits = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, zero)) & 0xFFFFFFFFULL;
+            w[i >> 6] |= bits << (i & 63); // i is a multiple of 32
+        }
+#endif
+        for (; i < n; i++)
+            if (p[i] != '0') w[i >> 6] |= 1ULL << (i & 63);
+    }
+}
+
+inline bool isSeparator(char ch) { return ch == ' ' || ch == ',' || ch == '\t'; }
+
+} // namespace gridfile
+
+// Text grid -> grid file. sentinel / pad describe the border of Char / Int
+// files (ignored for Bits; pad must be at least 1). Returns false if the text
+// can't be read, rows have different lengths, or a cell is not a digit.
+inline bool convertTextGrid(const string& textPath, const string& outPath, CellEncoding enc,
+                            long long sentinel = 0, int pad = 1) {
+    using namespace gridfile;
+    if (enc != CellEncoding::Bits && pad < 1) return false; // no sentinel border
+    int fd = open(textPath.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    size_t length = st.st_size;
+    const char* text = length ? (const char*)mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0) : "";
+    close(fd);
+    if (text == MAP_FAILED) return false;
+    if (length) madvise((void*)text, length, MADV_SEQUENTIAL);
+    const char* endOfText = text + length;
+
+    // Pass 1: line boundaries (memchr is vectorized in libc), row count, cols.
+    struct Line { const char* p; long long n; };
+    auto nextLine = [&](const char*& at, Line& line) {
+        while (at < endOfText) {
+            const char* nl = (const char*)memchr(at, '\n', endOfText - at);
+            if (!nl) nl = endOfText;
+            line = {at, nl - at};
+            at = nl + (nl < endOfText);
+            if (line.n && line.p[line.n - 1] == '\r') line.n--;
+            if (line.n) return true; // skip blank lines
+        }
+        return false;
+    };
+    auto cellsIn = [&](const Line& line) {
+        long long c = 0;
+        for (long long i = 0; i < line.n; i++) c += !isSeparator(line.p[i]);
+        return c;
+    };
+    long long rows = 0, cols = -1;
+    Line line;
+    for (const char* at = text; nextLine(at, line); rows++)
+        if (cols < 0) cols = cellsIn(line);
+    if (cols < 0) cols = 0;
+
+    bool bits = enc == CellEncoding::Bits;
+    int cellBytes = enc == CellEncoding::Char ? 1 : enc == CellEncoding::Int ? 4 : 8;
+    if (bits) pad = 0;
+    long long words = (cols + 63) / 64, stride = cols + 2LL * pad;
+    uint64_t dataBytes = bits ? rows * words * 8 : (rows + 2ULL * pad) * stride * cellBytes;
+    GridFileHeader h = header(cellBytes, bits ? uint32_t(GridFileHeader::BitPacked) : 0u, rows, cols, pad,
+                              bits ? 0 : sentinel, dataBytes);
+
+    // Output: sized with ftruncate and written through a shared mapping.
+    bool ok = false;
+    int out = open(outPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    char* dst = (char*)MAP_FAILED;
+    size_t outLength = DATA_OFFSET + dataBytes;
+    if (out >= 0 && ftruncate(out, outLength) == 0)
+        dst = (char*)mmap(nullptr, outLength, PROT_READ | PROT_WRITE, MAP_SHARED, out, 0);
+    if (dst != MAP_FAILED) {
+        memcpy(dst, &h, sizeof(h));
+        char* data = dst + DATA_OFFSET; // a fresh file reads as zeros
+        if (!bits && sentinel != 0) {   // border = sentinel
+            auto put = [&](long long i) {
+                if (cellBytes == 1) data[i] = (char)sentinel;
+                else ((int32_t*)data)[i] = (int32_t)sentinel;
+            };
+            for (long long r = 0; r < rows + 2LL * pad; r++)
+                for (long long c = 0; c < stride; c++)
+                    if (r < pad || r >= rows + pad || c < pad || c >= cols + pad) put(r * stride + c);
+        }
+
+        // Pass 2: the rows themselves.
+        ok = true;
+        vector<char> packed; // row with the separators removed
+        long long r = 0;
+        for (const char* at = text; ok && nextLine(at, line); r++) {
+            void* rowOut = bits ? (void*)(data + r * words * 8)
+                                : (void*)(data + ((r + pad) * stride + pad) * cellBytes);
+            const char* p = line.p;
+            long long n = line.n;
+            if (n != cols || !allDigits(p, n)) { // separators (or garbage): compact first
+                packed.clear();
+                for (long long i = 0; i < line.n; i++)
+                    if (!isSeparator(line.p[i])) packed.push_back(line.p[i]);
+                p = packed.data(), n = packed.size();
+                ok = n == cols && allDigits(p, n);
+            }
+            if (ok) convertDense(p, n, enc, rowOut);
+        }
+        ok = ok && munmap(dst, outLength) == 0;
+    }
+    if (out >= 0) close(out);
+    if (length) munmap((void*)text, length);
+    if (!ok) unlink(outPath.c_str());
+    return ok;
+}
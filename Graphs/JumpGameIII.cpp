@@ -1,8 +1,18 @@
+#include "Parallel.h"
+#include "TraversalStats.h"
+#include "TraversalWorkspace.h"
+
 class Solution {
 private:
-    void bfs(vector<int> arr, int index, bool& flag) {
-        queue<int> q;
+    // arr is read through a const reference (no copy of the whole array);
+    // visited indices go into a 1-byte-per-index array instead of
+    // overwriting arr with -1, and are marked when pushed so an index is
+    // queued at most once.
+    void bfs(const vector<int>& arr, int index, bool& flag) {
+        vector<char> seen(arr.size(), 0);
+        FrontierQueue<uint32_t> q; // indices fit an int, so 32 bits are enough
         q.push(index);
+        seen[index] = 1;
 
         while (!q.empty()) {
             int n = q.front();
@@ -14,11 +24,14 @@ private:
             }
 
             int jump = arr[n];
-            arr[n] = -1;
-            if (n - jump >= 0 && arr[n - jump] != -1)
+            if (n - jump >= 0 && !seen[n - jump]) {
+                seen[n - jump] = 1;
                 q.push(n - jump);
-            if (n + jump < arr.size() && arr[n + jump] != -1)
+            }
+            if (n + jump < (int)arr.size() && !seen[n + jump]) {
+                seen[n + jump] = 1;
                 q.push(n + jump);
+            }
         }
     }
 
@@ -28,4 +41,165 @@ public:
         bfs(arr, start, flag);
         return flag;
     }
+
+    // For many queries: arr is neither copied nor modified. Visited indices
+    // are the workspace's epoch-stamped set and its queue is reused, so a
+    // steady-state call allocates nothing.
+    bool canReach(const vector<int>& arr, int start, TraversalWorkspace& ws) {
+        STAT_SCOPE("canReach");
+        ws.seen.reset(arr.size());
+        ws.fifo.clear(); // the 32-bit queue: indices of arr fit
+        ws.fifo.push(start);
+        ws.seen.insert(start);
+        STAT_ENQUEUE(1, 1);
+
+        while (!ws.fifo.empty()) {
+            int n = ws.fifo.front();
+            ws.fifo.pop();
+            STAT_VISIT(1);
+            if (arr[n] == 0) return true;
+
+            for (int next : {n - arr[n], n + arr[n]}) {
+                if (next >= 0 && next < (int)arr.size() && !ws.seen.contains(next)) {
+                    ws.seen.insert(next);
+                    ws.fifo.push(next);
+                    STAT_ENQUEUE(1, ws.fifo.size());
+                }
+            }
+        }
+        return false;
+    }
+};
+
+/*
+Many start indices on the same array: JumpReachability
+Instead of one BFS per start, turn the question around:
+"which indices can reach SOME zero?"
+- Reverse jump graph: index j has edges j -> j - arr[j] and j -> j + arr[j].
+  Store the reversed edges (target -> list of j that jump onto it) in CSR
+  form: one offsets array + one flat array of sources, no vector per index.
+- One multi-source BFS over the reversed edges, starting from EVERY index
+  with arr[i] == 0. Everything it reaches can reach a zero.
+After that canReach(start) is a single array lookup.
+
+Parallel build (threads > 1, meant for arrays of 1e8+ elements):
+1. count in-edges per target (atomic adds, indices split between threads),
+2. prefix sums in blocks: each thread sums its block, the block totals are
+   scanned, then each thread finishes its block,
+3. place the edges (atomic "next free slot" per target),
+4. level-synchronous BFS: every thread expands its share of the frontier
+   into its own next-frontier list; an index is claimed with an atomic
+   exchange so exactly one thread pushes it.
+Memory: ~13 bytes per index (offsets + 2 edges as 32-bit ints + 1 byte flag)
+plus the BFS frontiers. Indices must fit in an int, like arr itself.
+*/
+class JumpReachability {
+public:
+    explicit JumpReachability(const vector<int>& arr, int threads = 1)
+        : n(arr.size()), good(arr.size(), 0) {
+        STAT_SCOPE("JumpReachability");
+        threads = max(1, threads);
+        vector<uint32_t> off(n + 1, 0);
+        vector<int> from;
+
+        // Step 1: off[t + 1] = number of edges into t
+        parallelFor(n, threads, [&](long long b, long long e) {
+            for (long long j = b; j < e; j++)
+                forEachJump(arr, j, [&](long long t) { add(off[t + 1], 1, threads > 1); });
+        });
+
+        // Step 2: inclusive prefix sums, in one block per thread
+        long long blocks = max(1LL, min<long long>(threads, n));
+        vector<uint32_t> blockSum(blocks + 1, 0);
+        auto block = [&](long long b) { return make_pair(1 + n * b / blocks, 1 + n * (b + 1) / blocks); };
+        parallelFor(blocks, threads, [&](long long b0, long long b1) {
+            for (long long b = b0; b < b1; b++) {
+                auto [lo, hi] = block(b);
+                for (long long i = lo + 1; i < hi; i++) off[i] += off[i - 1];
+                blockSum[b + 1] = hi > lo ? off[hi - 1] : 0;
+            }
+        });
+        partial_sum(blockSum.begin(), blockSum.end(), blockSum.begin());
+        parallelFor(blocks, threads, [&](long long b0, long long b1) {
+            for (long long b = b0; b < b1; b++) {
+                auto [lo, hi] = block(b);
+                for (long long i = lo; i < hi; i++) off[i] += blockSum[b];
+            }
+        });
+        // now off[t + 1] = end of t's edges, off[0] = 0
+
+        // Step 3: fill each target's range from its end; the cursor off[t + 1]
+        // ends up at the START of t's range, so shifting off left by one
+        // gives the usual CSR layout: t's edges are from[off[t] .. off[t + 1]).
+        from.resize(off[n]);
+        parallelFor(n, threads, [&](long long b, long long e) {
+            for (long long j = b; j < e; j++)
+                forEachJump(arr, j, [&](long long t) { from[add(off[t + 1], -1, threads > 1)] = j; });
+        });
+        rotate(off.begin(), off.begin() + 1, off.end());
+        off[n] = from.size();
+
+        // Step 4: multi-source BFS from every zero over the reversed edges
+        vector<vector<int>> next(threads);
+        vector<int> frontier;
+        for (long long i = 0; i < n; i++)
+            if (arr[i] == 0) good[i] = 1, frontier.push_back(i);
+        STAT_ENQUEUE(frontier.size(), frontier.size());
+        while (!frontier.empty()) {
+            STAT_LEVEL();
+            STAT_VISIT(frontier.size());
+            // small levels (long jump chains) are not worth starting threads for
+            long long size = frontier.size();
+            int parts = size < 65536 ? 1 : threads;
+            parallelFor(parts, parts, [&](long long p0, long long p1) {
+                for (long long p = p0; p < p1; p++) {
+                    for (long long k = size * p / parts; k < size * (p + 1) / parts; k++)
+                        for (uint32_t x = off[frontier[k]]; x < off[frontier[k] + 1]; x++)
+                            if (claim(good[from[x]], parts > 1)) next[p].push_back(from[x]);
+                }
+            });
+            frontier.clear();
+            for (auto& part : next) {
+                frontier.insert(frontier.end(), part.begin(), part.end());
+                part.clear();
+            }
+            STAT_LEVEL_END();
+            STAT_ENQUEUE(frontier.size(), frontier.size());
+        }
+    }
+
+    bool canReach(int start) const { return good[start]; }
+
+    long long reachableCount() const { return count(good.begin(), good.end(), 1); }
+
+private:
+    long long n;
+    vector<char> good; // 1 = can reach an index with value 0
+
+    // Calls f(target) for the 1 or 2 jumps out of j (a zero has none that matter).
+    template <class F>
+    static void forEachJump(const vector<int>& arr, long long j, F f) {
+        if (arr[j] == 0) return;
+        if (j - arr[j] >= 0) f(j - arr[j]);
+        if (j + arr[j] < (long long)arr.size()) f(j + arr[j]);
+    }
+
+    // x += d, returns the new value
+    static uint32_t add(uint32_t& x, int d, bool atomic) {
+        if (!atomic) return x += d;
+        return __atomic_add_fetch(&x, (uint32_t)d, __ATOMIC_RELAXED);
+    }
+
+    // Set flag to 1; true if this call is the one that changed it. With
+    // several threads the cheap pre-check is an atomic load too: other
+    // threads may be exchanging the same byte.
+    static bool claim(char& flag, bool atomic) {
+        if (!atomic) {
+            if (flag) return false;
+            flag = 1;
+            return true;
+        }
+        if (__atomic_load_n(&flag, __ATOMIC_RELAXED)) return false;
+        return __atomic_exchange_n(&flag, (char)1, __ATOMIC_RELAXED) == 0;
+    }
 };
@@ -1,48 +1,197 @@
-#include <bits/stdc++.h>
-using namespace std;
+#include "GridFile.h"
+#include "Neighborhood.h"
+#include "TraversalStats.h"
+#include "TraversalWorkspace.h"
 
-void bfsKnight(vector<vector<int>>& chessboard, pair<int, int> knightPos, pair<int, int> targetPos) {
-    queue<pair<int, int>> q;
-    q.push(knightPos);
-    chessboard[knightPos.first][knightPos.second] = 0;
+// The board has a 2-cell border of -1 (knight jumps reach two cells out),
+// so a knight move is just an index offset with no bounds check.
+// Returns the number of moves, or -1 if the target can't be reached.
+// As in the original, only the squares the knight lands on on the way must
+// be free: the start and the target square may hold an obstacle (the knight
+// captures it on the last jump).
+// The board is only read: distances (and with them the visited marks) live
+// in the workspace's epoch-stamped distA and the queue is the workspace's,
+// so repeated calls on the same board neither allocate nor clear anything.
+int bfsKnight(const Grid<int>& chessboard, pair<int, int> knightPos, pair<int, int> targetPos,
+              TraversalWorkspace& ws) {
+    STAT_SCOPE("bfsKnight");
+    long long start = chessboard.index(knightPos.first, knightPos.second);
+    long long target = chessboard.index(targetPos.first, targetPos.second);
+    if (start == target) return 0;
+    EpochArray<int>& dist = ws.distA;
+    dist.reset(chessboard.cells.size(), -1);
+    dist.set(start, 0);
 
-    int row = chessboard.size(), col = chessboard[0].size();
+    bool found = false;
+    ws.frontier(chessboard.cells.size(), [&](auto& q) {
+        q.push(start);
+        gridBfs<Knight>(chessboard, q,
+            [&](long long nxt) { return dist[nxt] == -1 && (nxt == target || chessboard[nxt] == 0); },
+            [&](long long nxt, long long cell) {
+                dist.set(nxt, dist[cell] + 1);
+                return found = nxt == target;
+            });
+    });
+    return found ? dist[target] : -1;
+}
 
-    vector<pair<int, int>> dirs = {{2, 1}, {2, -1}, {-2, 1}, {-2, -1}, {1, 2}, {-1, 2}, {1, -2}, {-1, -2}};
+int bfsKnight(const Grid<int>& chessboard, pair<int, int> knightPos, pair<int, int> targetPos) {
+    TraversalWorkspace ws;
+    return bfsKnight(chessboard, knightPos, targetPos, ws);
+}
 
-    while (!q.empty()) {
-        pair<int, int> cell = q.front();
-        q.pop();
+// Old signature, kept as a thin adapter over the Grid version. Like the
+// original it writes the distance of every square it reached into the board.
+int bfsKnight(vector<vector<int>>& chessboard, pair<int, int> knightPos, pair<int, int> targetPos) {
+    Grid<int> g = Grid<int>::from(chessboard, -1, 2);
+    TraversalWorkspace ws;
+    int moves = bfsKnight(g, knightPos, targetPos, ws);
+    for (int r = 0; r < g.rows; r++)
+        for (int c = 0; c < g.cols; c++)
+            if (ws.distA[g.index(r, c)] > 0) g(r, c) = ws.distA[g.index(r, c)];
+    g.copyTo(chessboard);
+    return moves;
+}
 
-        for (auto dir : dirs) {
-            int r = cell.first, c = cell.second, dr = dir.first, dc = dir.second;
-            int nr = r + dr, nc = c + dc;
+/*
+KnightOracle — answer lots of knight-distance queries without a BFS each time
 
-            if (nr == targetPos.first && nc == targetPos.second) {
-                cout << chessboard[r][c] + 1 << '\n';
-                return;
-            }
+1) Open board, both squares at least 2 cells away from every edge:
+   the board edge can't get in the way, so the answer is the infinite-board
+   knight distance, which has a closed form (dx >= dy >= 0):
+       (1, 0) -> 3,  (2, 2) -> 4,  otherwise with delta = dx - dy:
+       dy > delta ? delta - 2*floor((delta - dy) / 3)
+                  : delta - 2*floor((delta - dy) / 4)
+   O(1) per query, no memory.
+   (Checked against BFS for every pair on every board up to 26 x 26.)
+2) Squares near an edge/corner, or boards with obstacles:
+   run ONE BFS from the source over the whole board and cache that
+   distance field; every later query from the same source is a lookup.
+   distances() sorts such queries by source so each field is built once.
+   The cache holds at most maxFields fields and is simply cleared when full.
+   The board itself is only allocated once a query needs a BFS, so a huge
+   open board costs nothing as long as queries stay in the interior.
+Same rule as bfsKnight: only the squares the knight lands on on the way must
+be free, so the knight may start on an obstacle and may capture one on the
+target square (its distance is one jump more than the nearest reachable free
+square attacking it). Returns -1 when a square is off the board or the target
+can't be reached, and 0 when knight == target.
+*/
+class KnightOracle {
+public:
+    KnightOracle(int rows, int cols, const vector<pair<int, int>>& obstacles = {}, size_t maxFields = 64)
+        : rows(rows), cols(cols), maxFields(maxFields), open(obstacles.empty()), obstacles(obstacles) {}
+
+    int distance(pair<int, int> from, pair<int, int> to) {
+        if (!inside(from) || !inside(to)) return -1;
+        if (open && interior(from) && interior(to))
+            return from == to ? 0 : openDistance(to.first - from.first, to.second - from.second);
+        if (board.cells.empty()) buildBoard();
+        if (from == to) return 0;
+        const Grid<int>& dist = field(board.index(from.first, from.second));
+        if (board(to.first, to.second)) return dist(to.first, to.second);
+        // an obstacle on the target: capture it from the closest square that
+        // attacks it (obstacles other than the start are never reached, so -1)
+        int best = -1;
+        neighbors<Knight>(board)(board.index(to.first, to.second), [&](long long nb) {
+            if (dist[nb] >= 0 && (best == -1 || dist[nb] + 1 < best)) best = dist[nb] + 1;
+            return false;
+        });
+        return best;
+    }
 
-            if (nr < row && nr >= 0 && nc < col && nc >= 0 && chessboard[nr][nc] == 0) {
-                chessboard[nr][nc] = chessboard[r][c] + 1;
-                q.push({nr, nc});
-            }
+    vector<int> distances(const vector<pair<pair<int, int>, pair<int, int>>>& queries) {
+        vector<int> ans(queries.size(), -1);
+        vector<int> slow;
+        for (size_t i = 0; i < queries.size(); i++) {
+            auto& [from, to] = queries[i];
+            if (open && interior(from) && interior(to))
+                ans[i] = from == to ? 0 : openDistance(to.first - from.first, to.second - from.second);
+            else
+                slow.push_back(i);
         }
+        // group by source so every distance field is built at most once
+        stable_sort(slow.begin(), slow.end(), [&](int a, int b) { return queries[a].first < queries[b].first; });
+        for (int i : slow) ans[i] = distance(queries[i].first, queries[i].second);
+        return ans;
+    }
+
+    static int openDistance(int dx, int dy) {
+        dx = abs(dx), dy = abs(dy);
+        if (dx < dy) swap(dx, dy);
+        if (dx == 1 && dy == 0) return 3;
+        if (dx == 2 && dy == 2) return 4;
+        int delta = dx - dy;
+        if (dy > delta) return delta - 2 * floorDiv(delta - dy, 3);
+        return delta - 2 * ((delta - dy) / 4);
+    }
+
+private:
+    int rows, cols;
+    size_t maxFields;
+    bool open;
+    vector<pair<int, int>> obstacles;
+    Grid<char> board; // 1 = free square, 0 = obstacle / off the board
+    unordered_map<long long, Grid<int>> fields;
+    TraversalWorkspace ws; // BFS queue shared by every field() build
+
+    void buildBoard() {
+        board = Grid<char>(rows, cols, 1, 0, 2);
+        for (auto& o : obstacles) board(o.first, o.second) = 0;
+    }
+
+    static int floorDiv(int a, int b) { return a / b - (a % b != 0 && (a < 0) != (b < 0)); }
+
+    bool inside(pair<int, int> p) const {
+        return p.first >= 0 && p.first < rows && p.second >= 0 && p.second < cols;
+    }
+    bool interior(pair<int, int> p) const {
+        return p.first >= 2 && p.first < rows - 2 && p.second >= 2 && p.second < cols - 2;
     }
-}
 
-int main() {
+    // BFS distance field from src (cached)
+    const Grid<int>& field(long long src) {
+        auto it = fields.find(src);
+        if (it != fields.end()) return it->second;
+        if (fields.size() >= maxFields) fields.clear();
+        STAT_SCOPE("KnightOracle::field");
 
-    int n;
-    cin >> n;
-    vector<vector<int>> chessboard(n, vector<int> (n, 0));
+        Grid<int> dist(rows, cols, -1, -1, 2);
+        dist[src] = 0;
+        ws.frontier(board.cells.size(), [&](auto& q) {
+            q.push(src);
+            gridBfs<Knight>(board, q,
+                [&](long long nxt) { return board[nxt] && dist[nxt] == -1; },
+                [&](long long nxt, long long cell) { dist[nxt] = dist[cell] + 1; return false; });
+        });
+        return fields.emplace(src, move(dist)).first->second;
+    }
+};
+
+// Usage: ./knight [board file]
+// Without a file the board size n is read first. A board file comes from
+// convertTextGrid with CellEncoding::Int, sentinel -1 and pad 2
+// (0 = free square; a nonzero digit is an obstacle the knight can't use).
+int main(int argc, char** argv) {
+
+    Grid<int> chessboard;
+    if (argc > 1) {
+        if (!mapGrid(argv[1], chessboard, -1, 2)) {
+            cerr << "cannot read board file " << argv[1] << '\n';
+            return 1;
+        }
+    } else {
+        int n;
+        cin >> n;
+        chessboard = Grid<int>(n, n, 0, -1, 2);
+    }
 
     pair<int, int> knightPos;
     cin >> knightPos.first >> knightPos.second;
     pair<int, int> targetPos;
     cin >> targetPos.first >> targetPos.second;
 
-    bfsKnight(chessboard, knightPos, targetPos);
+    cout << bfsKnight(chessboard, knightPos, targetPos) << '\n';
 
     // if (chessboard[targetPos.first][targetPos.second] != 0) cout << chessboard[targetPos.first][targetPos.second] << '\n';
     // else cout << 0 << '\n';
@@ -0,0 +1,126 @@
+#pragma once
+#include "Grid.h"
+#include "TraversalStats.h"
+
+/*
+Neighborhood — compile-time move sets and one BFS core for every grid
+
+Every traversal used to carry its own list of moves (4 directions here,
+8 knight jumps there) and loop over it. The list lives in a runtime array,
+so the compiler keeps the loop and the per-move load.
+
+Here a move set is a TYPE:
+    Moves<dr0, dc0, dr1, dc1, ...>
+with the (row, col) steps as template arguments. Ready-made:
+    Four    up, down, left, right
+    Eight   Four + the 4 diagonals
+    Knight  the 8 knight jumps (needs a Grid with pad >= 2)
+and any other set is one line, e.g. a king that may also jump like a knight:
+    using KingKnight = Moves<-1,-1, -1,0, -1,1, 0,-1, 0,1, 1,-1, 1,0, 1,1,
+                             2,1, 2,-1, -2,1, -2,-1, 1,2, -1,2, 1,-2, -1,-2>;
+
+Because the number of moves is known at compile time, forEachNeighbor()
+expands to one straight-line block per move (no loop, no counter), and
+gridBfs() — the only queue-based BFS loop — is written once for all of them.
+
+The Grid's sentinel border must be at least N::reach cells wide, then no
+move can leave the padded block and no bounds check is needed.
+*/
+
+template <int... D>
+struct Moves {
+    static_assert(sizeof...(D) % 2 == 0, "Moves takes (dr, dc) pairs");
+    static constexpr int size = sizeof...(D) / 2;
+    static constexpr array<int, sizeof...(D)> delta = {D...};
+    static constexpr int reach = max({0, (D < 0 ? -D : D)...}); // border width needed
+
+    // Index offset of every move on a grid with this stride.
+    static array<long long, size> offsets(long long stride) {
+        array<long long, size> off{};
+        for (int i = 0; i < size; i++) off[i] = delta[2 * i] * stride + delta[2 * i + 1];
+        return off;
+    }
+};
+
+using Four = Moves<-1, 0, 1, 0, 0, -1, 0, 1>;
+using Eight = Moves<-1, 0, 1, 0, 0, -1, 0, 1, -1, -1, -1, 1, 1, -1, 1, 1>;
+using Knight = Moves<2, 1, 2, -1, -2, 1, -2, -1, 1, 2, -1, 2, 1, -2, -1, -2>;
+
+template <class F, size_t K, size_t... I>
+inline bool forEachNeighbor(const array<long long, K>& off, long long cell, F& f, index_sequence<I...>) {
+    return (f(cell + off[I]) || ...);
+}
+
+// Call f(neighbour index) for every move, unrolled. If f returns true the
+// remaining moves are skipped and true is returned.
+template <class F, size_t K>
+inline bool forEachNeighbor(const array<long long, K>& off, long long cell, F&& f) {
+    return forEachNeighbor(off, cell, f, make_index_sequence<K>{});
+}
+
+// How gridBfs reaches the N-neighbours of a cell on a flat Grid: one index
+// offset per move. (TiledGrid.h has the same for its tiled layout.)
+template <class N, class T>
+auto neighbors(const Grid<T>& grid) {
+    return [off = N::offsets(grid.stride)](long long cell, auto&& f) { return forEachNeighbor(off, cell, f); };
+}
+
+/*
+gridBfs<N>(grid, q, enter, visit)
+Level-order BFS over the moves N on a Grid or a TiledGrid, starting from
+the cells already in q (the caller marks them, like any BFS marks its
+sources). q is a FrontierQueue (TraversalWorkspace.h), 32- or 64-bit; every
+cell must be marked as it is pushed (enter() false for it from then on), so
+each cell is queued at most once.
+    enter(nxt)        may the search step onto nxt? — usually
+                      "open and not seen yet", read from the caller's arrays
+    visit(nxt, from)  nxt was reached from `from`: mark it / record distance.
+                      Return true to stop the whole search right here.
+Returns the depth of the last visited cell (0 if no cell was visited), so a
+"minutes until everything is reached" answer needs no separate counter.
+On a grid of more than bfsPrefetchBytes (about a last-level cache), while
+expanding a cell it prefetches the neighbours of the cell `bfsLookahead`
+places further down the queue, so their lines (for Four: the row above and
+the row below) are on their way by the time that cell is expanded. On a
+grid that fits in the cache the extra instructions only cost time.
+With -DTRAVERSAL_STATS it also counts visits, pushes, the queue's high-water
+mark and the time of every level (TraversalStats.h).
+*/
+constexpr size_t bfsLookahead = 16;
+constexpr size_t bfsPrefetchBytes = 32 << 20;
+
+template <class N, class G, class Queue, class Enter, class Visit>
+int gridBfs(const G& grid, Queue& q, Enter enter, Visit visit) {
+    const auto around = neighbors<N>(grid);
+    const bool prefetch = grid.cells.size() * sizeof(grid[0]) > bfsPrefetchBytes;
+    int depth = 0, last = 0;
+    STAT_SCOPE("gridBfs");
+    STAT_ENQUEUE(q.size(), q.size()); // the sources
+    while (!q.empty()) {
+        depth++;
+        STAT_LEVEL();
+        for (size_t size = q.size(); size > 0; size--) {
+            if (prefetch && q.size() > bfsLookahead)
+                around(q.ahead(bfsLookahead), [&](long long soon) {
+                    __builtin_prefetch(&grid[soon]);
+                    return false;
+                });
+            long long cell = q.front();
+            q.pop();
+            STAT_VISIT(1);
+            bool stop = around(cell, [&](long long nxt) {
+                if (!enter(nxt)) return false;
+                last = depth;
+                q.push(nxt);
+                STAT_ENQUEUE(1, q.size());
+                return (bool)visit(nxt, cell);
+            });
+            if (stop) {
+                STAT_LEVEL_END();
+                return last;
+            }
+        }
+    }
+    STAT_LEVEL_END();
+    return last;
+}
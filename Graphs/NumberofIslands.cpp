@@ -1,5 +1,11 @@
-#include <bits/stdc++.h>
-using namespace std;
+#include "BitGrid.h"
+#include "ConcurrentDSU.h"
+#include "GridFile.h"
+#include "Neighborhood.h"
+#include "Parallel.h"
+#include "TiledGrid.h"
+#include "TraversalStats.h"
+#include "TraversalWorkspace.h"
 
 /*
 Understanding your BFS approach 
@@ -26,27 +32,31 @@ Repeat until queue is empty → means the whole island is painted.
 
 */
 
-void bfs(int sr, int sc, vector<vector<char>>& grid, vector<vector<int>>& vis) {
-    int n = grid.size(), m = grid[0].size();
-    queue<pair<int,int>> q;
-    q.push({sr, sc});
-    vis[sr][sc] = 1;
+// G is Grid<char> or TiledGrid<char> (TiledGrid.h); vis has grid's shape.
+template <class G>
+void bfs(long long src, G& grid, G& vis) {
+    STAT_SCOPE("islands bfs");
+    vis[src] = 1;
 
-    vector<pair<int,int>> dirs = {{-1,0}, {1,0}, {0,-1}, {0,1}}; // up, down, left, right
+    // up, down, left, right; border cells are '0', so no bounds check is needed.
+    // vis is set on push, so a cell is queued at most once.
+    withFrontier(grid.cells.size(), [&](auto& q) {
+        q.push(src);
+        gridBfs<Four>(grid, q,
+            [&](long long nxt) { return grid[nxt] == '1' && !vis[nxt]; },
+            [&](long long nxt, long long) { vis[nxt] = 1; return false; });
+    });
+}
 
-    while (!q.empty()) {
-        auto cell = q.front(); 
-        q.pop();
-        for (auto dir : dirs) {
-            int r = cell.first, c = cell.second, dr = dir.first, dc = dir.second;
-            int nr = r + dr, nc = c + dc;
-            if (nr >= 0 && nr < n && nc >= 0 && nc < m 
-                && grid[nr][nc] == '1' && !vis[nr][nc]) {
-                vis[nr][nc] = 1;
-                q.push({nr, nc});
-            }
-        }
-    }
+// Old signature, kept as a thin adapter over the Grid version.
+void bfs(int sr, int sc, vector<vector<char>>& grid, vector<vector<int>>& vis) {
+    Grid<char> g = Grid<char>::from(grid, '0');
+    Grid<char> v(g.rows, g.cols, 0, 1);
+    for (int i = 0; i < g.rows; i++)
+        for (int j = 0; j < g.cols; j++) v(i, j) = vis[i][j] != 0;
+    bfs(g.index(sr, sc), g, v);
+    for (int i = 0; i < g.rows; i++)
+        for (int j = 0; j < g.cols; j++) vis[i][j] = v(i, j);
 }
 
 /*
@@ -66,28 +76,39 @@ void dfs(int r, int c, vector<vector<char>>& grid, vector<vector<int>>& vis) {
 }
 
 // DFS — Iterative (using stack)
-void dfsIter(int sr, int sc, vector<vector<char>>& grid, vector<vector<int>>& vis) {
-    int n = grid.size(), m = grid[0].size();
-    stack<pair<int,int>> st;
-    st.push({sr, sc});
-    vis[sr][sc] = 1;
+void dfsIter(long long src, Grid<char>& grid, Grid<char>& vis) {
+    STAT_SCOPE("islands dfsIter");
+    stack<long long> st;
+    st.push(src);
+    vis[src] = 1;
+    STAT_ENQUEUE(1, 1);
 
-    vector<pair<int,int>> dirs = {{-1,0}, {1,0}, {0,-1}, {0,1}};
+    array<long long, 4> off = Four::offsets(grid.stride);
 
     while (!st.empty()) {
-        auto cell = st.top(); st.pop();
-        for (auto dir : dirs) {
-            int r = cell.first, c = cell.second, dr = dir.first, dc = dir.second;
-            int nr = r + dr, nc = c + dc;
-            if (nr >= 0 && nr < n && nc >= 0 && nc < m 
-                && grid[nr][nc] == '1' && !vis[nr][nc]) {
-                vis[nr][nc] = 1;
-                st.push({nr, nc});
+        long long cell = st.top(); st.pop();
+        STAT_VISIT(1);
+        forEachNeighbor(off, cell, [&](long long nxt) {
+            if (grid[nxt] == '1' && !vis[nxt]) {
+                vis[nxt] = 1;
+                st.push(nxt);
+                STAT_ENQUEUE(1, st.size());
             }
-        }
+            return false;
+        });
     }
 }
 
+void dfsIter(int sr, int sc, vector<vector<char>>& grid, vector<vector<int>>& vis) {
+    Grid<char> g = Grid<char>::from(grid, '0');
+    Grid<char> v(g.rows, g.cols, 0, 1);
+    for (int i = 0; i < g.rows; i++)
+        for (int j = 0; j < g.cols; j++) v(i, j) = vis[i][j] != 0;
+    dfsIter(g.index(sr, sc), g, v);
+    for (int i = 0; i < g.rows; i++)
+        for (int j = 0; j < g.cols; j++) vis[i][j] = v(i, j);
+}
+
 /*
 (C) Union-Find / DSU
 Idea: Treat each land cell as a node in a graph.
@@ -105,6 +126,12 @@ public:
         size.resize(n, 1);
         iota(parent.begin(), parent.end(), 0);
     }
+    // Append a new singleton set and return its id.
+    int add() {
+        parent.push_back(parent.size());
+        size.push_back(1);
+        return parent.size() - 1;
+    }
     int find(int x) {
         if (parent[x] != x) parent[x] = find(parent[x]);
         return parent[x];
@@ -119,34 +146,577 @@ public:
     }
 };
 
-int numIslands(vector<vector<char>>& grid) {
-    int n = grid.size(), m = grid[0].size();
-    DSU dsu(n * m);
+int numIslands(Grid<char>& grid) {
+    DSU dsu(grid.cells.size());
     int landCount = 0;
-    vector<pair<int,int>> dirs = {{-1,0},{1,0},{0,-1},{0,1}};
-
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < m; j++) {
-            if (grid[i][j] == '1') {
-                landCount++;
-                int id1 = i * m + j;
-                for (auto dir : dirs) {
-                    int ni = i + dir.first, nj = j + dir.second;
-                    if (ni >= 0 && ni < n && nj >= 0 && nj < m && grid[ni][nj] == '1') {
-                        int id2 = ni * m + nj;
-                        if (dsu.find(id1) != dsu.find(id2)) {
-                            dsu.unite(id1, id2);
-                            landCount--;
-                        }
-                    }
+    // Scanning row by row, it is enough to look up and left:
+    // every edge between two land cells is seen exactly once.
+    long long up = -grid.stride, left = -1;
+
+    for (int i = 0; i < grid.rows; i++) {
+        for (int j = 0; j < grid.cols; j++) {
+            long long id1 = grid.index(i, j);
+            if (grid[id1] != '1') continue;
+            landCount++;
+            for (long long dir : {up, left}) {
+                long long id2 = id1 + dir;
+                if (grid[id2] == '1' && dsu.find(id1) != dsu.find(id2)) {
+                    dsu.unite(id1, id2);
+                    landCount--;
                 }
             }
         }
     }
     return landCount;
 }
+
+int numIslands(vector<vector<char>>& grid) {
+    Grid<char> g = Grid<char>::from(grid, '0');
+    return numIslands(g);
+}
 // This avoids explicit BFS/DFS.
 
+/*
+(D) Bit-packed runs (word-parallel)
+Store the grid as a BitGrid: 1 bit per cell instead of a char + an int in vis.
+Inside one row, land comes in runs of consecutive 1s. nextSet / nextClear find
+where a run starts and ends, skipping 64 cells per step.
+Each run becomes one DSU node (not each cell).
+Two runs in neighbouring rows touch iff their column ranges overlap, so a
+two-pointer sweep over the runs of the previous row and the current row finds
+every vertical connection.
+Islands = number of runs - number of successful unions.
+*/
+struct Run { int start, end, id; }; // columns [start, end)
+
+int numIslands(const BitGrid& grid) {
+    DSU dsu(0);
+    vector<Run> prev, cur;
+    int islands = 0;
+
+    for (int r = 0; r < grid.rows; r++) {
+        // Step 1: cut the row into runs of land
+        cur.clear();
+        for (int c = grid.nextSet(r, 0); c < grid.cols; c = grid.nextSet(r, c)) {
+            int end = grid.nextClear(r, c);
+            cur.push_back({c, end, dsu.add()});
+            islands++;
+            c = end;
+        }
+
+        // Step 2: union with every overlapping run of the row above
+        size_t i = 0;
+        for (Run& run : cur) {
+            while (i < prev.size() && prev[i].end <= run.start) i++;
+            for (size_t k = i; k < prev.size() && prev[k].start < run.end; k++) {
+                if (dsu.find(run.id) != dsu.find(prev[k].id)) {
+                    dsu.unite(run.id, prev[k].id);
+                    islands--;
+                }
+            }
+        }
+        swap(prev, cur);
+    }
+    return islands;
+}
+
+/*
+(E) Parallel tiled labeling
+Cut the grid into tileSize × tileSize tiles and give them out to worker threads.
+Phase 1 (parallel): each thread labels one tile on its own with the classic
+two-pass scan (take the label from up/left, union if both differ), using a
+small local DSU, and numbers that tile's components 1..k.
+Phase 2 (one thread): give every tile an offset so labels are globally unique,
+then walk only the tile seams and union labels of land cells that touch across
+a seam. This is the only shared union-find and it only sees seam cells.
+Phase 3 (parallel): rewrite every cell with its final island id.
+Returns the island count and a per-cell label map (0 = water, 1..count).
+Compile with -pthread.
+*/
+struct IslandLabels {
+    int count = 0;
+    Grid<int> label;
+};
+
+IslandLabels labelIslandsParallel(const Grid<char>& grid, int threads = thread::hardware_concurrency(),
+                                  int tileSize = 256) {
+    int n = grid.rows, m = grid.cols;
+    IslandLabels res;
+    res.label = Grid<int>(n, m, 0, 0, grid.pad); // same stride as grid
+    Grid<int>& label = res.label;
+    long long stride = grid.stride;
+
+    int tilesR = (n + tileSize - 1) / tileSize, tilesC = (m + tileSize - 1) / tileSize;
+    int tiles = tilesR * tilesC;
+    threads = max(1, min(threads, tiles));
+    vector<int> offset(tiles + 1, 0); // components per tile, later prefix sums
+
+    // Run work(tile) for every tile, threads pick the next tile from a counter
+    auto forEachTile = [&](auto work) {
+        atomic<int> next(0);
+        vector<thread> pool;
+        for (int t = 0; t < threads; t++)
+            pool.emplace_back([&] {
+                for (int k; (k = next++) < tiles;) work(k);
+            });
+        for (auto& th : pool) th.join();
+    };
+    auto tileOf = [&](int r, int c) { return r / tileSize * tilesC + c / tileSize; };
+
+    // Phase 1: label each tile independently
+    forEachTile([&](int k) {
+        int r0 = k / tilesC * tileSize, c0 = k % tilesC * tileSize;
+        int r1 = min(n, r0 + tileSize), c1 = min(m, c0 + tileSize);
+        DSU dsu(1); // id 0 = water
+
+        for (int r = r0; r < r1; r++) {
+            for (int c = c0; c < c1; c++) {
+                long long id = grid.index(r, c);
+                if (grid[id] != '1') continue;
+                int up = r > r0 ? label[id - stride] : 0;
+                int left = c > c0 ? label[id - 1] : 0;
+                if (!up && !left) label[id] = dsu.add();
+                else label[id] = up ? up : left;
+                if (up && left) dsu.unite(up, left);
+            }
+        }
+
+        vector<int> compact(dsu.parent.size(), 0);
+        int comps = 0;
+        for (int r = r0; r < r1; r++) {
+            for (int c = c0; c < c1; c++) {
+                long long id = grid.index(r, c);
+                if (!label[id]) continue;
+                int root = dsu.find(label[id]);
+                if (!compact[root]) compact[root] = ++comps;
+                label[id] = compact[root];
+            }
+        }
+        offset[k + 1] = comps;
+    });
+
+    // Phase 2: merge labels across tile seams
+    for (int k = 0; k < tiles; k++) offset[k + 1] += offset[k];
+    DSU dsu(offset[tiles]);
+    auto globalLabel = [&](int r, int c) {
+        return offset[tileOf(r, c)] + label(r, c) - 1;
+    };
+    for (int r = tileSize; r < n; r += tileSize)
+        for (int c = 0; c < m; c++)
+            if (label(r, c) && label(r - 1, c)) dsu.unite(globalLabel(r, c), globalLabel(r - 1, c));
+    for (int c = tileSize; c < m; c += tileSize)
+        for (int r = 0; r < n; r++)
+            if (label(r, c) && label(r, c - 1)) dsu.unite(globalLabel(r, c), globalLabel(r, c - 1));
+
+    vector<int> finalId(offset[tiles], 0);
+    for (int i = 0; i < offset[tiles]; i++) {
+        int root = dsu.find(i);
+        if (!finalId[root]) finalId[root] = ++res.count;
+        finalId[i] = finalId[root];
+    }
+
+    // Phase 3: write the final ids back
+    forEachTile([&](int k) {
+        int r0 = k / tilesC * tileSize, c0 = k % tilesC * tileSize;
+        int r1 = min(n, r0 + tileSize), c1 = min(m, c0 + tileSize);
+        for (int r = r0; r < r1; r++) {
+            for (int c = c0; c < c1; c++) {
+                long long id = label.index(r, c);
+                if (label[id]) label[id] = finalId[offset[k] + label[id] - 1];
+            }
+        }
+    });
+    return res;
+}
+
+/*
+(F) Union-Find with parallel union phase
+Same idea as (C), but the rows are split between threads and all of them
+unite into one lock-free ConcurrentDSU. unite() returns true only for the
+thread that really merged two sets, so
+islands = land cells - successful unions (summed over threads).
+*/
+int numIslandsParallel(Grid<char>& grid, int threads = thread::hardware_concurrency()) {
+    ConcurrentDSU dsu(grid.cells.size());
+    atomic<long long> islands(0);
+    long long up = -grid.stride, left = -1;
+
+    parallelFor(grid.rows, threads, [&](long long r0, long long r1) {
+        long long local = 0;
+        for (int i = r0; i < r1; i++) {
+            for (int j = 0; j < grid.cols; j++) {
+                long long id1 = grid.index(i, j);
+                if (grid[id1] != '1') continue;
+                local++;
+                for (long long dir : {up, left}) {
+                    long long id2 = id1 + dir;
+                    if (grid[id2] == '1' && dsu.unite(id1, id2)) local--;
+                }
+            }
+        }
+        islands += local;
+    });
+    return islands;
+}
+
+/*
+(G) Streaming, two rows at a time
+For rasters that do not fit in memory: read the grid one row (one text line)
+at a time, from a file or stdin. '1' is land, spaces / commas / tabs are
+skipped, anything else is water.
+Only two things are kept: the runs of the previous row (with the area of
+the set each one belongs to) and a tiny DSU with one node per run of the
+previous and current row.
+After each row:
+- a set that has no run in the current row can never grow again → it is a
+  finished island: count it (and remember its area),
+- the DSU is rebuilt with one node per surviving set ("compacted"), so its
+  size never exceeds the number of runs in one row.
+Memory is O(width), whatever the number of rows.
+*/
+struct StreamIslands {
+    long long count = 0;
+    vector<long long> areas; // only filled when asked for
+};
+
+StreamIslands countIslandsStream(istream& in, bool withAreas = false) {
+    StreamIslands res;
+    vector<Run> prev, cur;
+    vector<long long> prevArea; // area of each prev run's set, by prev run id
+    string line;
+
+    auto finish = [&](long long area) {
+        res.count++;
+        if (withAreas) res.areas.push_back(area);
+    };
+
+    while (getline(in, line)) {
+        // Step 1: cut the line into runs of land
+        cur.clear();
+        int col = 0, start = -1;
+        for (char ch : line) {
+            if (ch == ' ' || ch == ',' || ch == '\t' || ch == '\r') continue;
+            if (ch == '1') {
+                if (start < 0) start = col;
+            } else if (start >= 0) {
+                cur.push_back({start, col, 0});
+                start = -1;
+            }
+            col++;
+        }
+        if (start >= 0) cur.push_back({start, col, 0});
+
+        // Step 2: DSU over prev runs (ids 0..P-1) and cur runs (P..P+C-1)
+        int P = prev.size(), C = cur.size();
+        DSU dsu(P + C);
+
+        // prev runs already sharing a set are re-joined by their common id
+        for (int i = 0; i < P; i++) dsu.unite(i, prev[i].id);
+
+        size_t k0 = 0;
+        for (int i = 0; i < C; i++) {
+            while (k0 < prev.size() && prev[k0].end <= cur[i].start) k0++;
+            for (size_t k = k0; k < prev.size() && prev[k].start < cur[i].end; k++)
+                dsu.unite(P + i, k);
+        }
+
+        // Area of every set: old area (counted once per old set) + new runs
+        vector<long long> area(P + C, 0);
+        for (int i = 0; i < P; i++)
+            if (prev[i].id == i) area[dsu.find(i)] += prevArea[i];
+        for (int i = 0; i < C; i++) area[dsu.find(P + i)] += cur[i].end - cur[i].start;
+
+        // Step 3: sets without a run in this row are finished islands
+        vector<char> alive(P + C, 0), done(P + C, 0);
+        for (int i = 0; i < C; i++) alive[dsu.find(P + i)] = 1;
+        for (int i = 0; i < P; i++) {
+            int root = dsu.find(i);
+            if (!alive[root] && !done[root]) {
+                done[root] = 1;
+                finish(area[root]);
+            }
+        }
+
+        // Step 4: compact — cur run i remembers the first cur run of its set
+        vector<int> firstOf(P + C, -1);
+        prevArea.assign(C, 0);
+        for (int i = 0; i < C; i++) {
+            int root = dsu.find(P + i);
+            if (firstOf[root] < 0) firstOf[root] = i;
+            cur[i].id = firstOf[root];
+            prevArea[i] = area[root];
+        }
+        swap(prev, cur);
+    }
+
+    // Every set still open at the end of the input is an island
+    vector<char> done(prev.size(), 0);
+    for (size_t i = 0; i < prev.size(); i++) {
+        if (!done[prev[i].id]) {
+            done[prev[i].id] = 1;
+            finish(prevArea[i]);
+        }
+    }
+    return res;
+}
+
+/*
+(H) Online: water turns into land one cell at a time (IslandCounter)
+Instead of recounting after every event, keep the DSU alive:
+addLand(r, c) creates one new DSU node (+1 island) and unites it with each
+land neighbour; every successful union merges two islands (-1 island).
+Only land cells are stored: a hash map from (r, c) to the cell's DSU id,
+so the "grid" grows lazily and coordinates may be anywhere on an infinite
+plane (negative too). Amortized O(α) per event.
+*/
+class IslandCounter {
+public:
+    // Returns the island count after the event. Adding existing land is a no-op.
+    int addLand(int r, int c) {
+        long long k = key(r, c);
+        if (id.count(k)) return islands;
+        int me = dsu.add();
+        id[k] = me;
+        islands++;
+
+        int dr[4] = {-1, 1, 0, 0}, dc[4] = {0, 0, -1, 1};
+        for (int d = 0; d < 4; d++) {
+            auto it = id.find(key(r + dr[d], c + dc[d]));
+            if (it != id.end() && dsu.find(me) != dsu.find(it->second)) {
+                dsu.unite(me, it->second);
+                islands--;
+            }
+        }
+        return islands;
+    }
+
+    // Batch version: the count after each event, in order.
+    vector<int> addLand(const vector<pair<int,int>>& cells) {
+        id.reserve(id.size() + cells.size());
+        vector<int> counts;
+        counts.reserve(cells.size());
+        for (auto& cell : cells) counts.push_back(addLand(cell.first, cell.second));
+        return counts;
+    }
+
+    int count() const { return islands; }
+    bool isLand(int r, int c) const { return id.count(key(r, c)); }
+    bool sameIsland(int r1, int c1, int r2, int c2) {
+        auto a = id.find(key(r1, c1)), b = id.find(key(r2, c2));
+        return a != id.end() && b != id.end() && dsu.find(a->second) == dsu.find(b->second);
+    }
+
+private:
+    DSU dsu{0};
+    unordered_map<long long, int> id;
+    int islands = 0;
+
+    static long long key(int r, int c) { return (long long)(uint32_t)r << 32 | (uint32_t)c; }
+};
+
+/*
+(I) Offline: land appears AND erodes (divide and conquer over time)
+A normal DSU can't undo a union, so removals break (H). If the whole timeline
+of events is known up front:
+Step 1: every land cell is alive during some time intervals, and an edge
+between two neighbouring cells is alive while both are land (intersection
+of their intervals).
+Step 2: build a segment tree over the query times and store each edge in the
+O(log Q) nodes that cover its interval.
+Step 3: DFS the segment tree with a RollbackDSU (union by size, NO path
+compression, so every union can be undone): entering a node unites its
+edges, a leaf is one query, leaving a node rolls the unions back.
+At a leaf: islands = land cells alive now - unions currently applied.
+Total O((E + Q) log Q log N).
+Events are answered in order: Count gives the island count, Same gives
+1 if both cells are land and on the same island, else 0. Add on land and
+Remove on water are ignored.
+*/
+struct RollbackDSU {
+    vector<int> parent, size;
+    vector<pair<int,int>> history; // (kept root, attached root)
+
+    int add() {
+        parent.push_back(parent.size());
+        size.push_back(1);
+        return parent.size() - 1;
+    }
+    int find(int x) {
+        while (parent[x] != x) x = parent[x];
+        return x;
+    }
+    bool unite(int a, int b) {
+        a = find(a); b = find(b);
+        if (a == b) return false;
+        if (size[a] < size[b]) swap(a, b);
+        parent[b] = a;
+        size[a] += size[b];
+        history.push_back({a, b});
+        return true;
+    }
+    void rollback(size_t to) {
+        while (history.size() > to) {
+            auto [a, b] = history.back();
+            history.pop_back();
+            parent[b] = b;
+            size[a] -= size[b];
+        }
+    }
+};
+
+struct IslandEvent {
+    enum Type { Add, Remove, Count, Same } type;
+    int r, c;
+    int r2 = 0, c2 = 0; // second cell, Same only
+};
+
+vector<int> offlineIslands(const vector<IslandEvent>& events) {
+    int E = events.size();
+    auto key = [](int r, int c) { return (long long)(uint32_t)r << 32 | (uint32_t)c; };
+
+    // Step 1: land intervals [from, to) in event positions, land count and
+    // "both land" flags at every query
+    unordered_map<long long, int> id;          // cell -> DSU node
+    unordered_map<long long, int> since;       // cell -> position it became land
+    vector<vector<pair<int,int>>> alive;       // per node, sorted intervals
+    vector<int> queryPos, landAt;
+    vector<char> bothLand;
+    RollbackDSU dsu;
+    for (int i = 0; i < E; i++) {
+        const IslandEvent& e = events[i];
+        long long k = key(e.r, e.c);
+        if (e.type == IslandEvent::Add && !since.count(k)) {
+            if (!id.count(k)) {
+                id[k] = dsu.add();
+                alive.emplace_back();
+            }
+            since[k] = i;
+        } else if (e.type == IslandEvent::Remove && since.count(k)) {
+            alive[id[k]].push_back({since[k], i});
+            since.erase(k);
+        } else if (e.type == IslandEvent::Count || e.type == IslandEvent::Same) {
+            queryPos.push_back(i);
+            landAt.push_back(since.size());
+            bothLand.push_back(e.type == IslandEvent::Same && since.count(k) && since.count(key(e.r2, e.c2)));
+        }
+    }
+    for (auto& [k, from] : since) alive[id[k]].push_back({from, E});
+
+    // Step 2: edge intervals → segment tree over query indices
+    int Q = queryPos.size();
+    vector<int> ans(Q, 0);
+    if (Q == 0) return ans;
+    vector<vector<pair<int,int>>> tree(4 * Q);
+    function<void(int, int, int, int, int, pair<int,int>)> insert =
+        [&](int node, int l, int r, int ql, int qr, pair<int,int> edge) {
+            if (qr <= l || r <= ql) return;
+            if (ql <= l && r <= qr) {
+                tree[node].push_back(edge);
+                return;
+            }
+            int mid = (l + r) / 2;
+            insert(2 * node, l, mid, ql, qr, edge);
+            insert(2 * node + 1, mid, r, ql, qr, edge);
+        };
+    for (auto& [k, a] : id) {
+        int r = (int)(k >> 32), c = (int)(uint32_t)k;
+        for (long long nk : {key(r + 1, c), key(r, c + 1)}) {
+            auto it = id.find(nk);
+            if (it == id.end()) continue;
+            int b = it->second;
+            // two-pointer intersection of both cells' intervals
+            size_t i = 0, j = 0;
+            while (i < alive[a].size() && j < alive[b].size()) {
+                int from = max(alive[a][i].first, alive[b][j].first);
+                int to = min(alive[a][i].second, alive[b][j].second);
+                if (from < to) {
+                    int lo = upper_bound(queryPos.begin(), queryPos.end(), from) - queryPos.begin();
+                    int hi = lower_bound(queryPos.begin(), queryPos.end(), to) - queryPos.begin();
+                    if (lo < hi) insert(1, 0, Q, lo, hi, {a, b});
+                }
+                if (alive[a][i].second < alive[b][j].second) i++;
+                else j++;
+            }
+        }
+    }
+
+    // Step 3: DFS over time with rollback
+    function<void(int, int, int)> solve = [&](int node, int l, int r) {
+        size_t saved = dsu.history.size();
+        for (auto& [a, b] : tree[node]) dsu.unite(a, b);
+        if (r - l == 1) {
+            const IslandEvent& e = events[queryPos[l]];
+            if (e.type == IslandEvent::Count) {
+                ans[l] = landAt[l] - (int)dsu.history.size();
+            } else if (bothLand[l]) {
+                ans[l] = dsu.find(id[key(e.r, e.c)]) == dsu.find(id[key(e.r2, e.c2)]);
+            }
+        } else {
+            int mid = (l + r) / 2;
+            solve(2 * node, l, mid);
+            solve(2 * node + 1, mid, r);
+        }
+        dsu.rollback(saved);
+    };
+    solve(1, 0, Q);
+    return ans;
+}
+
+/*
+(J) Many queries on the same grid: BFS / DFS with a TraversalWorkspace
+Same traversals as above, but `vis` is the workspace's epoch-stamped `seen`
+set and the queue / stack are the workspace's, so after the first query
+on a grid of this size numIslands(grid, ws) makes no heap allocation and
+does not clear an N×M array. bfs / dfsIter use ws.seen as set up by the
+caller (reset once per grid, then one call per island).
+*/
+template <class G> // Grid<char> or TiledGrid<char>
+void bfs(long long src, const G& grid, TraversalWorkspace& ws) {
+    STAT_SCOPE("islands bfs");
+    ws.seen.insert(src);
+    ws.frontier(grid.cells.size(), [&](auto& q) {
+        q.push(src);
+        gridBfs<Four>(grid, q,
+            [&](long long nxt) { return grid[nxt] == '1' && !ws.seen.contains(nxt); },
+            [&](long long nxt, long long) { ws.seen.insert(nxt); return false; });
+    });
+}
+
+void dfsIter(long long src, const Grid<char>& grid, TraversalWorkspace& ws) {
+    STAT_SCOPE("islands dfsIter");
+    array<long long, 4> off = Four::offsets(grid.stride);
+    ws.lifo.assign(1, src);
+    ws.seen.insert(src);
+    STAT_ENQUEUE(1, 1);
+    while (!ws.lifo.empty()) {
+        long long cell = ws.lifo.back();
+        ws.lifo.pop_back();
+        STAT_VISIT(1);
+        forEachNeighbor(off, cell, [&](long long nxt) {
+            if (grid[nxt] == '1' && !ws.seen.contains(nxt)) {
+                ws.seen.insert(nxt);
+                ws.lifo.push_back(nxt);
+                STAT_ENQUEUE(1, ws.lifo.size());
+            }
+            return false;
+        });
+    }
+}
+
+template <class G> // Grid<char> or TiledGrid<char>
+int numIslands(const G& grid, TraversalWorkspace& ws) {
+    STAT_SCOPE("numIslands");
+    ws.seen.reset(grid.cells.size());
+    int count = 0;
+    grid.forEachCell([&](long long id) {
+        if (grid[id] == '1' && !ws.seen.contains(id)) {
+            count++;
+            bfs(id, grid, ws);
+        }
+    });
+    return count;
+}
+
 /*
 Time & Space Complexity
 | Approach         | Time Complexity          | Space Complexity                   | Notes                                  |
@@ -155,9 +725,19 @@ Time & Space Complexity
 | DFS (recursive)  | O(N×M)                   | O(N×M) (recursion stack + visited) | Risk of stack overflow for huge grids  |
 | DFS (iterative)  | O(N×M)                   | O(N×M) (stack + visited)           | Safe from recursion depth limits       |
 | Union-Find (DSU) | O(N×M × α(N×M)) ≈ O(N×M) | O(N×M)                             | α = inverse Ackermann, almost constant |
+| Bit-packed runs  | O(N×M/64 + R × α(R))     | N×M/8 bytes + O(R) for R runs      | 1 bit per cell, 64 cells per step      |
+| Parallel tiles   | O(N×M / P + seams)       | O(N×M) (label map)                 | P threads, also returns island labels  |
+| Parallel DSU     | O(N×M × α / P)           | O(N×M) (atomic parents)            | Lock-free CAS unions, P threads        |
+| Streaming rows   | O(N×M)                   | O(M)                               | Reads row by row, can report areas     |
+| Online addLand   | O(α) per event           | O(land cells)                      | Running count, grid grows lazily       |
+| Offline add/del  | O((E + Q) log Q log N)   | O(E log Q)                         | Rollback DSU, answers every query      |
+| BFS + workspace  | O(N×M)                   | O(N×M), reused between queries     | No allocation / clearing per query     |
 */
 
-int main() {
+// Usage: ./islands [grid file]
+// The file comes from convertTextGrid (GridFile.h) with CellEncoding::Char
+// and sentinel '0', or CellEncoding::Bits. It is used in place (mmap).
+int main(int argc, char** argv) {
     vector<vector<char>> grid = {
         {'1','1','0','0','0'},
         {'1','1','0','0','0'},
@@ -165,15 +745,27 @@ int main() {
         {'0','0','0','1','1'}
     };
 
-    int n = grid.size(), m = grid[0].size();
-    vector<vector<int>> vis(n, vector<int>(m, 0));
+    Grid<char> g = Grid<char>::from(grid, '0');
+    if (argc > 1) {
+        BitGrid bits;
+        if (mapBitGrid(argv[1], bits)) {
+            cout << numIslands(bits) << "\n";
+            return 0;
+        }
+        if (!mapGrid(argv[1], g, '0')) {
+            cerr << "cannot read grid file " << argv[1] << "\n";
+            return 1;
+        }
+    }
+    Grid<char> vis(g.rows, g.cols, 0, 1, g.pad); // same shape as g: indices are shared
     int count = 0;
 
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < m; j++) {
-            if (grid[i][j] == '1' && !vis[i][j]) {
+    for (int i = 0; i < g.rows; i++) {
+        for (int j = 0; j < g.cols; j++) {
+            long long id = g.index(i, j);
+            if (g[id] == '1' && !vis[id]) {
                 count++;
-                bfs(i, j, grid, vis);
+                bfs(id, g, vis);
             }
         }
     }
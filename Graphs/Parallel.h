@@ -0,0 +1,18 @@
+#pragma once
+#include <bits/stdc++.h>
+using namespace std;
+
+// Split [0, n) into `threads` contiguous chunks and run fn(begin, end) for
+// each chunk on its own thread. Compile with -pthread.
+template <class F>
+void parallelFor(long long n, int threads, F fn) {
+    threads = max(1, (int)min<long long>(threads, n));
+    if (threads == 1) {
+        fn(0LL, n);
+        return;
+    }
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++)
+        pool.emplace_back(fn, n * t / threads, n * (t + 1) / threads);
+    for (auto& th : pool) th.join();
+}
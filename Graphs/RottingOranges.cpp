@@ -1,5 +1,12 @@
-#include <bits/stdc++.h>
-using namespace std;
+#include "BitFrontierBFS.h"
+#include "GridFile.h"
+#include "Neighborhood.h"
+#include "TiledGrid.h"
+#include "TraversalStats.h"
+#include "TraversalWorkspace.h"
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 /*
 Step-by-step explanation 
@@ -22,47 +29,364 @@ Infection spreads equally in all directions.
 BFS guarantees we count the minimum time for each orange to rot.
 */
 
-// BFS Approach
+// BFS Approach (on the flat Grid, border cells are empty = 0).
+// The queue is the workspace's, so repeated calls allocate nothing.
+// G is a Grid<int> or a TiledGrid<int> (TiledGrid.h).
+template <class G>
+int orangesRotting(G& grid, TraversalWorkspace& ws) {
+    STAT_SCOPE("orangesRotting");
+    return ws.frontier(grid.cells.size(), [&](auto& q) {
+        int fresh = 0;
+
+        // Step 1: Push all initially rotten oranges into queue
+        grid.forEachCell([&](long long id) {
+            if (grid[id] == 2) q.push(id);
+            fresh += grid[id] == 1; // counted without a branch
+        });
+
+        if (fresh == 0) return 0;
+
+        // Step 2: BFS, one level = one minute. Border is empty (0), so only the
+        // "is fresh" check remains; stop as soon as the last fresh orange rots.
+        // An orange rots as it is pushed, so it is never queued twice.
+        int time = gridBfs<Four>(grid, q,
+            [&](long long nxt) { return grid[nxt] == 1; },
+            [&](long long nxt, long long) {
+                grid[nxt] = 2; // rot it
+                return --fresh == 0;
+            });
+
+        return fresh == 0 ? time : -1;
+    });
+}
+
+int orangesRotting(Grid<int>& grid) {
+    TraversalWorkspace ws;
+    return orangesRotting(grid, ws);
+}
+
+// Old signature, kept as a thin adapter over the Grid version.
 int orangesRotting(vector<vector<int>>& grid) {
-    int row = grid.size(), col = grid[0].size();
-    queue<pair<int,int>> q;
-    int fresh = 0;
-        
-    // Step 1: Push all initially rotten oranges into queue
-    for (int i = 0; i < row; i++) {
-    for (int j = 0; j < col; j++) {
-        if (grid[i][j] == 2) q.push({i, j});
-            else if (grid[i][j] == 1) fresh++;
+    Grid<int> g = Grid<int>::from(grid, 0);
+    int time = orangesRotting(g);
+    g.copyTo(grid);
+    return time;
+}
+
+/*
+Bitset frontier version
+Same minute-by-minute spread, but fresh and rotten oranges are bitsets and
+each minute is one BitFrontierBFS::step(): top-down while only a few oranges
+are rotting, bottom-up (shifted AND/OR over 64 cells at a time) once the
+infection front is large. The grid is not modified.
+*/
+int orangesRottingBitset(const Grid<int>& grid) {
+    STAT_SCOPE("orangesRottingBitset");
+    BitGrid fresh = BitGrid::from(grid, 1);
+    BitGrid rotten = BitGrid::from(grid, 2);
+    BitFrontierBFS bfs(fresh, rotten);
+    while (bfs.step()) {}
+    return bfs.unreached() ? -1 : bfs.level();
+}
+
+/*
+Bitplane cellular automaton (AVX2 with scalar fallback)
+The spread is a cellular automaton: every minute
+    rotten |= (rotten shifted up/down/left/right) & fresh
+Keep fresh and rotten as bitplanes (1 bit per cell; empty is simply
+"neither", so it needs no plane of its own) and apply the rule to the whole
+grid each tick. With AVX2 one instruction handles 256 cells; without it the
+same loop runs on 64-bit words.
+Every row gets a zero guard word on both sides, and there is a zero guard row
+above and below, so the shifted loads never need a bounds check.
+Stops when a tick changes nothing. Returns the minutes, or -1 if fresh
+oranges are left. If `curve` is given it receives (fresh, rotten) counts
+for minute 0, 1, 2, ...
+*/
+struct RotPlanes {
+    int rows, cols, words;
+    long long stride;                  // words per row incl. guards, (multiple of 4) + 2
+    vector<uint64_t> fresh, rotten, next;
+
+    RotPlanes(const Grid<int>& grid) : rows(grid.rows), cols(grid.cols) {
+        words = ((cols + 63) / 64 + 3) / 4 * 4;
+        stride = words + 2;
+        fresh.assign((rows + 2) * stride, 0);
+        rotten = next = fresh;
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                uint64_t bit = 1ULL << (c & 63);
+                if (grid(r, c) == 1) fresh[word(r, c)] |= bit;
+                if (grid(r, c) == 2) rotten[word(r, c)] |= bit;
+            }
         }
     }
-        
-    vector<pair<int,int>> dirs = {{-1,0},{1,0},{0,-1},{0,1}};
-    int time = 0;
 
-    // Step 2: BFS
-        while (!q.empty() && fresh > 0) {
-            int size = q.size(); // all rotten oranges for this minute
-            for (int i = 0; i < size; i++) {
-                pair<int,int> p = q.front();
-                q.pop();
+    long long word(int r, int c) const { return (r + 1) * stride + 1 + (c >> 6); }
 
-                for (int d = 0; d < dirs.size(); d++) {
-                    int nx = p.first + dirs[d].first;
-                    int ny = p.second + dirs[d].second;
+    static long long popcount(const vector<uint64_t>& v) {
+        long long total = 0;
+        for (uint64_t w : v) total += __builtin_popcountll(w);
+        return total;
+    }
 
-                    // Check boundaries & if fresh
-                    if (nx >= 0 && nx < row && ny >= 0 && ny < col && grid[nx][ny] == 1) {
-                        grid[nx][ny] = 2; // rot it
-                        fresh--;
-                        q.push(make_pair(nx, ny));
+    // One minute. Returns how many oranges rotted (0 = nothing changed).
+    long long tick() {
+        long long rotted = 0;
+        for (int r = 0; r < rows; r++) {
+            long long k = (r + 1) * stride + 1, end = k + words;
+            const uint64_t* R = rotten.data();
+            uint64_t* F = fresh.data();
+            uint64_t* N = next.data();
+#ifdef __AVX2__
+            for (; k < end; k += 4) {
+                auto load = [](const uint64_t* p) { return _mm256_loadu_si256((const __m256i*)p); };
+                __m256i c = load(R + k);
+                __m256i nb = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_slli_epi64(c, 1), _mm256_srli_epi64(load(R + k - 1), 63)),
+                    _mm256_or_si256(_mm256_srli_epi64(c, 1), _mm256_slli_epi64(load(R + k + 1), 63)));
+                nb = _mm256_or_si256(nb, _mm256_or_si256(load(R + k - stride), load(R + k + stride)));
+                __m256i f = load(F + k);
+                __m256i add = _mm256_and_si256(nb, f);
+                _mm256_storeu_si256((__m256i*)(N + k), _mm256_or_si256(c, add));
+                _mm256_storeu_si256((__m256i*)(F + k), _mm256_andnot_si256(add, f));
+                if (!_mm256_testz_si256(add, add)) {
+                    alignas(32) uint64_t lanes[4];
+                    _mm256_store_si256((__m256i*)lanes, add);
+                    for (uint64_t w : lanes) rotted += __builtin_popcountll(w);
+                }
+            }
+#endif
+            for (; k < end; k++) {
+                uint64_t c = R[k];
+                uint64_t nb = c << 1 | R[k - 1] >> 63 | c >> 1 | R[k + 1] << 63 | R[k - stride] | R[k + stride];
+                uint64_t add = nb & F[k];
+                N[k] = c | add;
+                F[k] &= ~add;
+                rotted += __builtin_popcountll(add);
+            }
+        }
+        swap(rotten, next);
+        return rotted;
+    }
+};
+
+int orangesRottingBitplane(const Grid<int>& grid, vector<pair<long long, long long>>* curve = nullptr) {
+    STAT_SCOPE("orangesRottingBitplane");
+    RotPlanes planes(grid);
+    long long fresh = RotPlanes::popcount(planes.fresh), rotten = RotPlanes::popcount(planes.rotten);
+    if (curve) curve->push_back({fresh, rotten});
+
+    int minutes = 0;
+    while (fresh > 0) {
+        STAT_LEVEL();
+        long long rotted = planes.tick();
+        STAT_VISIT(rotted);
+        STAT_LEVEL_END();
+        if (!rotted) break;
+        fresh -= rotted;
+        rotten += rotted;
+        minutes++;
+        if (curve) curve->push_back({fresh, rotten});
+    }
+    return fresh ? -1 : minutes;
+}
+
+/*
+Incremental re-evaluation after edits (RottingSimulation)
+Keep, for every orange, the minute it gets infected (= BFS distance from the
+nearest rotten orange through fresh ones). The answer is the largest of those
+minutes, or -1 if some fresh orange has no minute at all.
+set(r, c, value) changes one cell and repairs only what the edit affects:
+- Decrease (a new rotten orange, a new fresh orange that bridges a gap):
+  the changed cell gets its new minute and a small BFS pushes the smaller
+  minutes outward, stopping where nothing improves.
+- Increase (a rotten or reachable fresh orange removed / turned fresh):
+  Step 1: walk down the BFS levels from the changed cell and collect every
+  orange that lost its last neighbour one minute earlier — those are the
+  only minutes that can change ("affected" cells).
+  Step 2: each affected orange restarts from its best unaffected neighbour,
+  then a Dijkstra over just the affected region settles the new minutes.
+A histogram of minutes gives the new maximum; the number of unreachable fresh
+oranges is updated as cells change. Cost ~ size of the changed region.
+*/
+struct RotStatus {
+    int maxTime = 0;           // latest infection minute
+    long long unreachable = 0; // fresh oranges that never rot
+    int minutes() const { return unreachable ? -1 : maxTime; }
+};
+
+class RottingSimulation {
+public:
+    RottingSimulation(const Grid<int>& grid)
+        : kind(grid.rows, grid.cols, 0, 0), time(grid.rows, grid.cols, INF, INF) {
+        ws.frontier(kind.cells.size(), [&](auto& q) {
+            for (int r = 0; r < grid.rows; r++) {
+                for (int c = 0; c < grid.cols; c++) {
+                    long long i = kind.index(r, c);
+                    kind[i] = grid(r, c);
+                    if (kind[i] == 2) {
+                        time[i] = 0;
+                        q.push(i);
+                    }
+                    remember(i);
+                }
+            }
+            while (!q.empty()) {
+                long long u = q.front();
+                q.pop();
+                for (long long d : kind.dirs4()) {
+                    long long v = u + d;
+                    if (kind[v] == 1 && time[v] == INF) {
+                        retime(v, time[u] + 1);
+                        q.push(v);
                     }
                 }
             }
-            time++; // One minute passed
+        });
+    }
+
+    // value: 0 = empty, 1 = fresh, 2 = rotten
+    RotStatus set(int r, int c, int value) {
+        long long i = kind.index(r, c);
+        if (kind[i] == value) return status();
+
+        // Increase phase: the cell stops being a (possible) source
+        vector<long long> affected;
+        if (time[i] != INF && value != 2) collectAffected(i, affected);
+        forget(i);
+        kind[i] = value;
+        remember(i);
+
+        if (value == 1 && time[i] == INF) affected.push_back(i);
+        if (!affected.empty()) settle(affected);
+
+        // Decrease phase
+        if (value == 2) {
+            retime(i, 0);
+            spread(i);
         }
+        return status();
+    }
 
-    return fresh == 0 ? time : -1;
-}
+    RotStatus status() {
+        while (maxT > 0 && hist[maxT] == 0) maxT--;
+        return {maxT, unreachable};
+    }
+
+    int infectionTime(int r, int c) const {
+        int t = time(r, c);
+        return t == INF ? -1 : t;
+    }
+
+private:
+    static const int INF = INT_MAX;
+    Grid<int> kind, time;
+    TraversalWorkspace ws;        // the queue every update reuses
+    vector<long long> hist = {0}; // hist[t] = oranges infected at minute t
+    long long unreachable = 0;
+    int maxT = 0;
+
+    // Add / remove cell i's contribution to hist and unreachable.
+    void remember(long long i) {
+        if (kind[i] == 0) return;
+        if (time[i] == INF) {
+            if (kind[i] == 1) unreachable++;
+            return;
+        }
+        if (time[i] >= (int)hist.size()) hist.resize(time[i] + 1, 0);
+        hist[time[i]]++;
+        maxT = max(maxT, time[i]);
+    }
+    void forget(long long i) {
+        if (kind[i] == 0) return;
+        if (time[i] == INF) {
+            if (kind[i] == 1) unreachable--;
+            return;
+        }
+        hist[time[i]]--;
+    }
+    void retime(long long i, int t) {
+        forget(i);
+        time[i] = t;
+        remember(i);
+    }
+
+    // Push smaller minutes outward from u (unit weights, one seed → BFS order,
+    // so the first minute a cell gets is final and it is queued once).
+    void spread(long long u) {
+        ws.frontier(kind.cells.size(), [&](auto& q) {
+            q.push(u);
+            while (!q.empty()) {
+                long long x = q.front();
+                q.pop();
+                for (long long d : kind.dirs4()) {
+                    long long y = x + d;
+                    if (kind[y] == 1 && time[y] > time[x] + 1) {
+                        retime(y, time[x] + 1);
+                        q.push(y);
+                    }
+                }
+            }
+        });
+    }
+
+    // Step 1 of the increase phase: i and every orange whose minute depended
+    // on it lose their minute. Fresh ones are returned in `affected`.
+    // The queue holds cell indices only: a cell pushed while expanding level
+    // k had old minute time[i] + k + 1, so the old minute is the level's.
+    void collectAffected(long long i, vector<long long>& affected) {
+        ws.frontier(kind.cells.size(), [&](auto& q) {
+            int t = time[i]; // old minute of the cells in the current level
+            q.push(i);
+            retime(i, INF);
+            for (; !q.empty(); t++) {
+                for (size_t n = q.size(); n > 0; n--) {
+                    long long u = q.front();
+                    q.pop();
+                    for (long long d : kind.dirs4()) {
+                        long long v = u + d;
+                        if (kind[v] != 1 || time[v] != t + 1) continue;
+                        bool supported = false;
+                        for (long long e : kind.dirs4())
+                            if (time[v + e] == t) supported = true;
+                        if (supported) continue;
+                        q.push(v);
+                        retime(v, INF); // no longer t + 1: never pushed again
+                        affected.push_back(v);
+                    }
+                }
+            }
+        });
+    }
+
+    // Step 2 of the increase phase: Dijkstra over the affected cells.
+    void settle(const vector<long long>& affected) {
+        priority_queue<pair<int, long long>, vector<pair<int, long long>>, greater<>> pq;
+        for (long long a : affected) {
+            if (kind[a] != 1) continue;
+            int best = INF;
+            for (long long d : kind.dirs4())
+                if (time[a + d] != INF) best = min(best, time[a + d] + 1);
+            if (best < time[a]) {
+                retime(a, best);
+                pq.push({best, a});
+            }
+        }
+        while (!pq.empty()) {
+            auto [t, x] = pq.top();
+            pq.pop();
+            if (t != time[x]) continue;
+            for (long long d : kind.dirs4()) {
+                long long y = x + d;
+                if (kind[y] == 1 && time[y] > t + 1) {
+                    retime(y, t + 1);
+                    pq.push({t + 1, y});
+                }
+            }
+        }
+    }
+};
 
 /*
 DFS isn’t naturally time-layered like BFS, but we can make it work by passing time as a parameter and keeping track of the minimum time each cell gets infected.
@@ -86,7 +410,7 @@ void dfs(vector<vector<int>>& grid, int x, int y, int time, vector<vector<int>>&
     }
 }
 
-int orangesRotting(vector<vector<int>>& grid) {
+int orangesRottingDfs(vector<vector<int>>& grid) {
     int row = grid.size(), col = grid[0].size();
     vector<vector<int>> minTime(row, vector<int>(col, INT_MAX));
 
@@ -114,7 +438,7 @@ int orangesRotting(vector<vector<int>>& grid) {
 */
 
 struct State { int x, y, time; };
-int orangesRotting(vector<vector<int>>& grid) {
+int orangesRottingDfsIter(vector<vector<int>>& grid) {
     int row = grid.size(), col = grid[0].size();
     vector<vector<int>> minTime(row, vector<int>(col, INT_MAX));
     stack<State> st;
@@ -176,10 +500,23 @@ Complexity Analysis
 | DFS Iterative          | O(m × n) worst  | O(m × n) stack   | No recursion limit             | Still revisits cells            |
 | Brute Force Simulation | O(T × m × n)    | O(1)             | Easy to code                   | Very slow                       |
 | Union-Find             | O(m × n α(mn))  | O(m × n)         | Interesting modeling           | Not practical for time problems |
+| Bitset frontier BFS    | O(T × m × n/64) | 3 bits per cell  | Word-parallel minutes          | Dense steps cost a full sweep   |
+| Bitplane automaton     | O(T × m × n/256)| 3 bits per cell  | AVX2, 256 cells per op         | Sweeps whole grid every minute  |
 
 */
 
-int main() {
+// Usage: ./rotting [grid file]   (CellEncoding::Int, sentinel 0)
+int main(int argc, char** argv) {
+
+    if (argc > 1) {
+        Grid<int> g;
+        if (!mapGrid(argv[1], g, 0)) {
+            cerr << "cannot read grid file " << argv[1] << '\n';
+            return 1;
+        }
+        cout << orangesRotting(g) << '\n';
+        return 0;
+    }
 
     vector<vector<int>> grid = {
         {2,1,1},{0,1,1},{1,0,1}
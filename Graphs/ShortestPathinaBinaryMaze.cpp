@@ -26,30 +26,452 @@ Why BFS works for shortest path here:
 Because BFS always processes the closest cells first, the first time you reach a cell, you’ve already found the shortest path to it.
 */
 
-#include <bits/stdc++.h>
-using namespace std;
+#include "GridFile.h"
+#include "Neighborhood.h"
+#include "TraversalStats.h"
+#include "TraversalWorkspace.h"
 
+// mat's border is blocked (0), so neighbours need no bounds check.
+// The queue comes from the workspace (no allocation once it has grown).
+void bfs(Grid<int>& mat, pair<int,int> src, pair<int,int> dest, Grid<int>& dist, TraversalWorkspace& ws) {
+    STAT_SCOPE("maze bfs");
+    long long s = mat.index(src.first, src.second);
+    dist[s] = 0;
+
+    // Up, Down, Left, Right; dist is written on push, so each cell is queued once
+    ws.frontier(mat.cells.size(), [&](auto& q) {
+        q.push(s);
+        gridBfs<Four>(mat, q,
+            [&](long long nxt) { return dist[nxt] == -1 && mat[nxt] == 1; },
+            [&](long long nxt, long long cell) { dist[nxt] = dist[cell] + 1; return false; });
+    });
+}
+
+void bfs(Grid<int>& mat, pair<int,int> src, pair<int,int> dest, Grid<int>& dist) {
+    TraversalWorkspace ws;
+    bfs(mat, src, dest, dist, ws);
+}
+
+// Old signature, kept as a thin adapter over the Grid version.
 void bfs(vector<vector<int>>& mat, pair<int,int> src, pair<int,int> dest, vector<vector<int>>& dist) {
-    int row = mat.size(), col = mat[0].size();
-    queue<pair<int,int>> q;
-    q.push(src);
-    dist[src.first][src.second] = 0;
+    Grid<int> m = Grid<int>::from(mat, 0);
+    Grid<int> d = Grid<int>::from(dist, -1);
+    bfs(m, src, dest, d);
+    d.copyTo(dist);
+}
 
-    vector<pair<int,int>> dirs = {{-1,0},{1,0},{0,-1},{0,1}}; // Up, Down, Left, Right
+/*
+Route output: 2 or 3 bits per cell instead of an int distance
+bfs only fills dist; getting the route itself would need a parent for every
+cell (a pair<int,int> = 8 bytes, or a long long index). But a cell's parent
+is always one of its neighbours, so it is enough to remember WHICH move
+reached it: 4 moves fit in 2 bits, 8 moves in 3 bits.
+- back:    Bits per cell, packed 32 (2-bit) or 21 (3-bit) to a 64-bit word
+           (PackedCodes, TraversalWorkspace.h)
+- visited: 1 bit per cell (all 4 / 8 codes are used, so "unvisited" needs
+           its own bit), plus an epoch stamp per 64 cells (EpochBits)
+That is 3.5 bits per cell for Four and 4.5 for Eight, against 32 for dist.
+Both live in the workspace: a repeated query with the same workspace
+allocates nothing and clears nothing (stale words just read as unvisited).
+Once dest is reached the search stops, and the route is read backwards:
+step from dest against the stored move until src is reached.
+The route is returned run-length encoded: a count, then the move, where
+N = row - 1, S = row + 1, W = col - 1, E = col + 1 (Eight adds NW, NE,
+SW, SE). "3E2S1E" = 3 x east, 2 x south, 1 x east. A corridor maze has
+few turns, so even a million-step route is a short string.
+*/
 
-    while (!q.empty()) {
-        pair<int, int> cell = q.front(); 
-        q.pop();
+struct MazeRoute {
+    int dist = -1;  // -1 = dest not reachable
+    string moves;   // run-length encoded moves from src to dest, "" when src == dest
+};
 
-        for (auto  dir: dirs) {
-            int nr = cell.first + dir.first, nc = cell.second + dir.second;
-            if (nr >= 0 && nr < row && nc >= 0 && nc < col &&
-                dist[nr][nc] == -1 && mat[nr][nc] == 1) {
-                dist[nr][nc] = dist[cell.first][cell.second] + 1;
-                q.push({nr, nc});
+// "N", "SE", ... for a move of at most one row and one column.
+string moveName(int dr, int dc) {
+    return string(dr < 0 ? "N" : dr > 0 ? "S" : "") + (dc < 0 ? "W" : dc > 0 ? "E" : "");
+}
+
+// N = Four or Eight (any move set of single steps with at most 8 moves).
+template <class N = Four>
+MazeRoute bfsRoute(const Grid<int>& mat, pair<int,int> src, pair<int,int> dest, TraversalWorkspace& ws) {
+    static_assert(N::reach == 1 && N::size <= 8, "one code per move, at most 3 bits");
+    constexpr int bits = N::size <= 4 ? 2 : 3;
+    STAT_SCOPE("maze bfsRoute");
+    MazeRoute res;
+    long long s = mat.index(src.first, src.second), t = mat.index(dest.first, dest.second);
+    if (mat[s] != 1 || mat[t] != 1) return res;
+    if (s == t) {
+        res.dist = 0;
+        return res;
+    }
+
+    PackedCodes<bits> back(ws.moves, mat.cells.size());
+    EpochBits& visited = ws.reached;
+    const array<long long, N::size> off = N::offsets(mat.stride);
+    visited.reset(mat.cells.size());
+    visited.insert(s);
+    int depth = ws.frontier(mat.cells.size(), [&](auto& q) {
+        q.push(s);
+        // gridBfs stops at the first visit that returns true, so the depth
+        // it reports is dest's distance.
+        return gridBfs<N>(mat, q,
+            [&](long long nxt) { return mat[nxt] == 1 && !visited.contains(nxt); },
+            [&](long long nxt, long long cell) {
+                unsigned k = 0;
+                while (cell + off[k] != nxt) k++; // which move: at most 8 compares
+                visited.insert(nxt);
+                back.set(nxt, k);
+                return nxt == t;
+            });
+    });
+    if (!visited.contains(t)) return res;
+    res.dist = depth;
+
+    // Walk back from dest, collecting (move, count) runs in reverse order.
+    vector<pair<unsigned, long long>> runs;
+    for (long long cell = t; cell != s;) {
+        unsigned k = back.get(cell);
+        if (!runs.empty() && runs.back().first == k) runs.back().second++;
+        else runs.push_back({k, 1});
+        cell -= off[k];
+    }
+    for (auto it = runs.rbegin(); it != runs.rend(); ++it)
+        res.moves += to_string(it->second) + moveName(N::delta[2 * it->first], N::delta[2 * it->first + 1]);
+    return res;
+}
+
+template <class N = Four>
+MazeRoute bfsRoute(const Grid<int>& mat, pair<int,int> src, pair<int,int> dest) {
+    TraversalWorkspace ws;
+    return bfsRoute<N>(mat, src, dest, ws);
+}
+
+// The cells of an encoded route, src first. Returns {} for a malformed string.
+vector<pair<int,int>> expandRoute(pair<int,int> src, const string& moves) {
+    vector<pair<int,int>> cells = {src};
+    size_t i = 0;
+    while (i < moves.size()) {
+        long long count = 0;
+        while (i < moves.size() && isdigit((unsigned char)moves[i])) count = count * 10 + (moves[i++] - '0');
+        int dr = 0, dc = 0;
+        if (i < moves.size() && (moves[i] == 'N' || moves[i] == 'S')) dr = moves[i++] == 'N' ? -1 : 1;
+        if (i < moves.size() && (moves[i] == 'W' || moves[i] == 'E')) dc = moves[i++] == 'W' ? -1 : 1;
+        if (count == 0 || (dr == 0 && dc == 0)) return {};
+        for (; count > 0; count--) cells.push_back({cells.back().first + dr, cells.back().second + dc});
+    }
+    return cells;
+}
+
+/*
+Bidirectional BFS (point-to-point, stops early)
+The plain bfs fills dist for the whole maze even if dest is 3 steps away.
+Here two BFS waves grow at the same time: one from src, one from dest.
+Each round we expand one full level of the SMALLER frontier.
+As soon as a wave reaches a cell the other wave has already seen, the
+two searches have met. We finish that level (the best meeting point is in
+it) and stop. On an open maze each wave only covers a radius of ~d/2
+instead of d, and often much less than the whole grid.
+distance = distFromSrc(u) + 1 + distFromDest(v) for the meeting edge (u, v).
+The path (if asked) is read back from the two distance grids: from the
+meeting cell walk downhill in distFromSrc to src, and in distFromDest to dest.
+Both distance grids, both frontiers (and A*'s heap below) live in a
+TraversalWorkspace, so repeated queries with the same workspace neither
+allocate nor clear an N×M array.
+*/
+struct PathResult {
+    int dist = -1;                  // -1 = dest not reachable
+    vector<pair<int,int>> path;     // src ... dest, only filled when asked for
+};
+
+// Walk from cell to the cell with distance 0 by always stepping to a
+// neighbour whose distance is one less. d is a Grid<int> or an EpochArray<int>.
+template <class Dist>
+void walkDownhill(const Grid<int>& mat, const Dist& d, long long cell, vector<long long>& out) {
+    array<long long, 4> dirs = mat.dirs4();
+    while (d[cell] > 0) {
+        for (long long dir : dirs) {
+            if (d[cell + dir] == d[cell] - 1) {
+                cell += dir;
+                break;
+            }
+        }
+        out.push_back(cell);
+    }
+}
+
+PathResult bidirectionalBfs(Grid<int>& mat, pair<int,int> src, pair<int,int> dest, TraversalWorkspace& ws,
+                            bool withPath = false) {
+    STAT_SCOPE("bidirectionalBfs");
+    PathResult res;
+    long long s = mat.index(src.first, src.second), t = mat.index(dest.first, dest.second);
+    if (mat[s] != 1 || mat[t] != 1) return res;
+
+    EpochArray<int>& distS = ws.distA;
+    EpochArray<int>& distT = ws.distB;
+    distS.reset(mat.cells.size(), -1);
+    distT.reset(mat.cells.size(), -1);
+    vector<long long>& frontS = ws.frontA;
+    vector<long long>& frontT = ws.frontB;
+    vector<long long>& next = ws.next;
+    frontS.assign(1, s);
+    frontT.assign(1, t);
+    distS.set(s, 0);
+    distT.set(t, 0);
+    STAT_ENQUEUE(2, 2);
+    array<long long, 4> dirs = mat.dirs4();
+
+    long long meetA = -1, meetB = -1; // meeting edge, meetA on the src side
+    int best = s == t ? 0 : INT_MAX;
+    if (s == t) meetA = meetB = s;
+
+    while (best == INT_MAX && !frontS.empty() && !frontT.empty()) {
+        bool fromSrc = frontS.size() <= frontT.size();
+        vector<long long>& front = fromSrc ? frontS : frontT;
+        EpochArray<int>& mine = fromSrc ? distS : distT;
+        EpochArray<int>& other = fromSrc ? distT : distS;
+
+        // expand one whole level of the smaller frontier
+        STAT_LEVEL();
+        STAT_VISIT(front.size());
+        next.clear();
+        for (long long cell : front) {
+            for (long long dir : dirs) {
+                long long nxt = cell + dir;
+                if (mat[nxt] != 1) continue;
+                if (other[nxt] != -1 && mine[cell] + 1 + other[nxt] < best) {
+                    STAT_RELAX();
+                    best = mine[cell] + 1 + other[nxt];
+                    meetA = fromSrc ? cell : nxt;
+                    meetB = fromSrc ? nxt : cell;
+                }
+                if (mine[nxt] == -1) {
+                    mine.set(nxt, mine[cell] + 1);
+                    next.push_back(nxt);
+                }
             }
         }
+        STAT_LEVEL_END();
+        STAT_ENQUEUE(next.size(), next.size() + (fromSrc ? frontT : frontS).size());
+        swap(front, next);
+    }
+    if (best == INT_MAX) return res;
+    res.dist = best;
+
+    if (withPath) {
+        vector<long long> half = {meetA}, tail = {meetB};
+        walkDownhill(mat, distS, meetA, half);
+        reverse(half.begin(), half.end());
+        if (meetB != meetA) walkDownhill(mat, distT, meetB, tail);
+        else tail.clear();
+        half.insert(half.end(), tail.begin(), tail.end());
+        for (long long cell : half) res.path.push_back({mat.row(cell), mat.col(cell)});
     }
+    return res;
+}
+
+PathResult bidirectionalBfs(Grid<int>& mat, pair<int,int> src, pair<int,int> dest, bool withPath = false) {
+    TraversalWorkspace ws;
+    return bidirectionalBfs(mat, src, dest, ws, withPath);
+}
+
+PathResult bidirectionalBfs(vector<vector<int>>& mat, pair<int,int> src, pair<int,int> dest, bool withPath = false) {
+    Grid<int> m = Grid<int>::from(mat, 0);
+    return bidirectionalBfs(m, src, dest, withPath);
+}
+
+/*
+A* (informed search)
+BFS grows a circle around src. A* always expands the cell with the smallest
+    f = g (steps from src) + h (Manhattan distance to dest),
+so it heads straight for dest and only spreads out around obstacles.
+Manhattan distance never overestimates on a 4-connected grid, so the first
+time dest is popped its g is the shortest distance. Ties on f prefer the
+larger g (the cell closer to dest).
+The path is read back from g exactly like in bidirectionalBfs.
+*/
+PathResult aStar(Grid<int>& mat, pair<int,int> src, pair<int,int> dest, TraversalWorkspace& ws,
+                 bool withPath = false) {
+    STAT_SCOPE("aStar");
+    PathResult res;
+    long long s = mat.index(src.first, src.second), t = mat.index(dest.first, dest.second);
+    if (mat[s] != 1 || mat[t] != 1) return res;
+
+    EpochArray<int>& g = ws.distA;
+    g.reset(mat.cells.size(), -1);
+    auto h = [&](long long cell) {
+        return abs(mat.row(cell) - dest.first) + abs(mat.col(cell) - dest.second);
+    };
+    // (f, -g, cell): smallest f first, then largest g
+    vector<tuple<int,int,long long>>& pq = ws.heap;
+    pq.clear();
+    auto push = [&](tuple<int,int,long long> e) {
+        pq.push_back(e);
+        push_heap(pq.begin(), pq.end(), greater<>());
+        STAT_ENQUEUE(1, pq.size());
+    };
+    array<long long, 4> dirs = mat.dirs4();
+
+    g.set(s, 0);
+    push({h(s), 0, s});
+    while (!pq.empty()) {
+        pop_heap(pq.begin(), pq.end(), greater<>());
+        auto [f, negG, cell] = pq.back();
+        pq.pop_back();
+        if (-negG != g[cell]) continue; // stale entry
+        STAT_VISIT(1);
+        if (cell == t) break;
+
+        for (long long dir : dirs) {
+            long long nxt = cell + dir;
+            int cand = g[cell] + 1;
+            if (mat[nxt] == 1 && (g[nxt] == -1 || cand < g[nxt])) {
+                if (g[nxt] != -1) STAT_RELAX();
+                g.set(nxt, cand);
+                push({cand + h(nxt), -cand, nxt});
+            }
+        }
+    }
+    if (g[t] == -1) return res;
+    res.dist = g[t];
+
+    if (withPath) {
+        vector<long long> cells = {t};
+        walkDownhill(mat, g, t, cells);
+        reverse(cells.begin(), cells.end());
+        for (long long cell : cells) res.path.push_back({mat.row(cell), mat.col(cell)});
+    }
+    return res;
+}
+
+/*
+Jump Point Search (4-connected)
+On open ground A* still pushes every cell of a straight corridor into the
+heap. JPS instead "jumps": from a node it keeps walking in one direction,
+without touching the heap, until something interesting happens:
+- it hits dest,
+- a forced neighbour appears: a side cell is open but the side cell one step
+  behind was blocked (a wall just ended, so a new shortest path may turn here),
+- (vertical moves only) a horizontal jump from this cell finds a jump point.
+Only those jump points go into the A* heap, with g = steps walked.
+When a jump point is expanded we only jump forward and to both sides
+(never back where we came from); src jumps in all 4 directions.
+g and the parent of each jump point live in the workspace's epoch-stamped
+arrays: only jump points are ever written, and nothing has to be cleared
+before the next query. The path is rebuilt by joining consecutive jump
+points with straight lines.
+*/
+long long jump(Grid<int>& mat, long long cell, long long d, long long goal) {
+    bool vertical = d != 1 && d != -1;
+    long long side = vertical ? 1 : mat.stride;
+    while (true) {
+        cell += d;
+        if (mat[cell] != 1) return -1;
+        if (cell == goal) return cell;
+        for (long long p : {side, -side})
+            if (mat[cell + p] == 1 && mat[cell - d + p] != 1) return cell; // forced neighbour
+        if (vertical && (jump(mat, cell, 1, goal) != -1 || jump(mat, cell, -1, goal) != -1)) return cell;
+    }
+}
+
+PathResult jumpPointSearch(Grid<int>& mat, pair<int,int> src, pair<int,int> dest, TraversalWorkspace& ws,
+                           bool withPath = false) {
+    STAT_SCOPE("jumpPointSearch");
+    PathResult res;
+    long long s = mat.index(src.first, src.second), t = mat.index(dest.first, dest.second);
+    if (mat[s] != 1 || mat[t] != 1) return res;
+
+    EpochArray<int>& g = ws.distA;
+    EpochArray<long long>& parent = ws.parent;
+    g.reset(mat.cells.size(), -1);
+    parent.reset(mat.cells.size(), -1);
+    auto h = [&](long long cell) {
+        return abs(mat.row(cell) - dest.first) + abs(mat.col(cell) - dest.second);
+    };
+    auto steps = [&](long long a, long long b) {
+        return abs(mat.row(a) - mat.row(b)) + abs(mat.col(a) - mat.col(b));
+    };
+    vector<tuple<int,int,long long>>& pq = ws.heap;
+    pq.clear();
+    auto push = [&](tuple<int,int,long long> e) {
+        pq.push_back(e);
+        push_heap(pq.begin(), pq.end(), greater<>());
+        STAT_ENQUEUE(1, pq.size());
+    };
+
+    g.set(s, 0);
+    parent.set(s, s);
+    push({h(s), 0, s});
+    while (!pq.empty()) {
+        pop_heap(pq.begin(), pq.end(), greater<>());
+        auto [f, negG, cell] = pq.back();
+        pq.pop_back();
+        if (-negG != g[cell]) continue;
+        STAT_VISIT(1);
+        if (cell == t) break;
+
+        // directions to try: all 4 from src, else forward + both sides
+        long long dirs[4];
+        int nd = 0;
+        if (cell == s) {
+            for (long long d : mat.dirs4()) dirs[nd++] = d;
+        } else {
+            long long from = parent[cell];
+            long long d = mat.row(cell) == mat.row(from) ? (cell > from ? 1 : -1)
+                                                         : (cell > from ? mat.stride : -mat.stride);
+            long long side = (d == 1 || d == -1) ? mat.stride : 1;
+            dirs[nd++] = d, dirs[nd++] = side, dirs[nd++] = -side;
+        }
+
+        for (int k = 0; k < nd; k++) {
+            long long jp = jump(mat, cell, dirs[k], t);
+            if (jp == -1) continue;
+            int cand = g[cell] + steps(cell, jp);
+            if (g[jp] == -1 || cand < g[jp]) {
+                if (g[jp] != -1) STAT_RELAX();
+                g.set(jp, cand);
+                parent.set(jp, cell);
+                push({cand + h(jp), -cand, jp});
+            }
+        }
+    }
+    if (g[t] == -1) return res;
+    res.dist = g[t];
+
+    if (withPath) {
+        vector<long long> points = {t};
+        while (points.back() != s) points.push_back(parent[points.back()]);
+        reverse(points.begin(), points.end());
+        res.path.push_back(src);
+        for (size_t i = 1; i < points.size(); i++) {
+            long long a = points[i - 1], b = points[i];
+            long long d = mat.row(a) == mat.row(b) ? (b > a ? 1 : -1) : (b > a ? mat.stride : -mat.stride);
+            for (long long cell = a; cell != b;) {
+                cell += d;
+                res.path.push_back({mat.row(cell), mat.col(cell)});
+            }
+        }
+    }
+    return res;
+}
+
+PathResult aStar(Grid<int>& mat, pair<int,int> src, pair<int,int> dest, bool withPath = false) {
+    TraversalWorkspace ws;
+    return aStar(mat, src, dest, ws, withPath);
+}
+
+PathResult jumpPointSearch(Grid<int>& mat, pair<int,int> src, pair<int,int> dest, bool withPath = false) {
+    TraversalWorkspace ws;
+    return jumpPointSearch(mat, src, dest, ws, withPath);
+}
+
+PathResult aStar(vector<vector<int>>& mat, pair<int,int> src, pair<int,int> dest, bool withPath = false) {
+    Grid<int> m = Grid<int>::from(mat, 0);
+    return aStar(m, src, dest, withPath);
+}
+
+PathResult jumpPointSearch(vector<vector<int>>& mat, pair<int,int> src, pair<int,int> dest, bool withPath = false) {
+    Grid<int> m = Grid<int>::from(mat, 0);
+    return jumpPointSearch(m, src, dest, withPath);
 }
 
 /*
@@ -127,12 +549,17 @@ Time & Space Complexity Summary
 | Approach      | Shortest Path?          | Time Complexity   | Space Complexity                 |
 | ------------- | ----------------------- | ----------------- | -------------------------------- |
 | BFS           | ✅ Yes                   | `O(R*C)`          | `O(R*C)` for dist + queue        |
+| BFS + route   | ✅ Yes (and the route)   | `O(R*C)`          | 3 bits/cell (4 with Eight) + queue |
+| Bidirectional | ✅ Yes                   | `O(explored)`     | `O(R*C)` for two dist grids      |
+| A*            | ✅ Yes                   | `O(E log E)`      | `O(R*C)` for g + heap            |
+| Jump Point    | ✅ Yes                   | `O(J log J)` + scans | `O(J)` for J jump points      |
 | DFS Recursive | ❌ Not guaranteed        | `O(R*C)`          | `O(R*C)` for visited + recursion |
 | DFS Iterative | ❌ Not guaranteed        | `O(R*C)`          | `O(R*C)` for visited + stack     |
 | Union-Find    | ❌ Not for shortest path | `O(R*C * α(R*C))` | `O(R*C)`                         |
 */
 
-int main() {
+// Usage: ./maze [grid file]   (CellEncoding::Int, sentinel 0)
+int main(int argc, char** argv) {
 
     vector<vector<int>> mat = {
         {1, 1, 1, 1, 1}, 
@@ -141,19 +568,23 @@ int main() {
         {1, 0, 1, 0, 1}
     };
 
-    int row = mat.size(), col = mat[0].size();
+    Grid<int> grid = Grid<int>::from(mat, 0);
+    if (argc > 1 && !mapGrid(argv[1], grid, 0)) {
+        cerr << "cannot read grid file " << argv[1] << '\n';
+        return 1;
+    }
 
     pair<int, int> source;
     pair<int, int> destination;
 
-    vector<vector<int>> dist(row, vector<int> (col, -1));;
+    Grid<int> dist(grid.rows, grid.cols, -1, -1, grid.pad); // same shape as grid: indices are shared
 
     cin >> source.first >> source.second;
     cin >> destination.first >> destination.second;
 
-    bfs(mat, source, destination, dist);
+    bfs(grid, source, destination, dist);
 
-    cout << dist[destination.first][destination.second];
+    cout << dist(destination.first, destination.second);
 
     return 0;
 }
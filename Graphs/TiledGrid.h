@@ -0,0 +1,154 @@
+#pragma once
+#include "Grid.h"
+#include "Neighborhood.h"
+
+/*
+TiledGrid<T> — the same padded grid, stored tile by tile in Z-order
+
+Why?
+In a row-major Grid the cell below is `stride` cells away. Flood fill,
+island BFS and rotting oranges grow in 2D blobs, so on a grid much larger
+than the last-level cache almost every vertical step lands on another cache
+line, and on a wide grid on another 4 KB page (a TLB miss) too.
+
+Layout:
+The padded grid (real cells + `pad` sentinel cells on every side) is cut
+into square tiles of side = 2^S cells (S = 5: 32 × 32; a tile of ints is
+exactly one 4 KB page). Tiles are stored one after another, row by row.
+Inside a tile the cells are in Morton (Z) order: the bits of the local
+column and row are interleaved,
+    local = ... r1 c1 r0 c0
+so every 2 × 2, 4 × 4, 8 × 8 ... block is contiguous: a 4 × 4 block of ints
+is one 64-byte cache line, and a blob that stays inside a tile touches one
+page.
+
+O(1) neighbour arithmetic, no branch:
+The column bits (even positions) and row bits (odd positions) are "dilated"
+integers. Adding 1 to the column: set the row bits to 1 so the carry runs
+through them, add, keep the column bits:
+    c' = ((x | rowBits) + 1) & colBits
+A carry (or borrow) out of the top bit means the step left the tile: move
+to the next (previous) tile, +-tileCells for columns, +-tileRowCells for
+rows. step<dr, dc>() does this with the move known at compile time, so a
+neighbour costs a handful of ALU operations instead of one add.
+Any move with |dr|, |dc| < side works (knight moves included); as with Grid
+the border must be at least N::reach wide.
+
+The rows / cols of tiles are rounded up to whole tiles; the extra cells hold
+the sentinel like the border. Every Grid routine written against
+index(r, c) / operator[] / forEachCell and gridBfs works on both layouts:
+gridBfs picks the neighbour arithmetic through neighbors<N>(grid).
+*/
+
+template <class T, int S = 5>
+struct TiledGrid {
+    static_assert(S >= 1 && S <= 8, "tile side must be 2..256");
+    static constexpr int side = 1 << S;
+    static constexpr long long tileCells = 1LL << (2 * S);
+    static constexpr long long colBits = 0x5555555555555555LL & (tileCells - 1);
+    static constexpr long long rowBits = colBits << 1;
+
+    int rows = 0, cols = 0, pad = 1;
+    long long tilesPerRow = 0, tileRows = 0, tileRowCells = 0;
+    T sentinel{};
+    CellStore<T> cells;
+
+    TiledGrid() {}
+
+    TiledGrid(int rows, int cols, T fill, T sentinel, int pad = 1)
+        : rows(rows), cols(cols), pad(pad), tilesPerRow((cols + 2LL * pad + side - 1) >> S),
+          tileRows((rows + 2LL * pad + side - 1) >> S), tileRowCells(tilesPerRow * tileCells), sentinel(sentinel),
+          cells(tileRows * tileRowCells, sentinel) {
+        forEachCell([&](long long i) { cells[i] = fill; });
+    }
+
+    // Same cells, sentinel and pad as g, in the tiled layout.
+    static TiledGrid from(const Grid<T>& g) {
+        TiledGrid t(g.rows, g.cols, g.sentinel, g.sentinel, g.pad);
+        for (int r = 0; r < g.rows; r++)
+            for (int c = 0; c < g.cols; c++) t(r, c) = g(r, c);
+        return t;
+    }
+
+    Grid<T> toGrid() const {
+        Grid<T> g(rows, cols, sentinel, sentinel, pad);
+        for (int r = 0; r < rows; r++)
+            for (int c = 0; c < cols; c++) g(r, c) = (*this)(r, c);
+        return g;
+    }
+
+    // Spread the low 8 bits of x to the even bit positions, and back.
+    static constexpr long long dilate(long long x) {
+        x &= 0xFF;
+        x = (x | x << 4) & 0x0F0F;
+        x = (x | x << 2) & 0x3333;
+        return (x | x << 1) & 0x5555;
+    }
+    static constexpr int undilate(long long d) {
+        d &= 0x5555;
+        d = (d | d >> 1) & 0x3333;
+        d = (d | d >> 2) & 0x0F0F;
+        return (d | d >> 4) & 0xFF;
+    }
+
+    long long index(int r, int c) const {
+        long long pr = r + pad, pc = c + pad;
+        return ((pr >> S) * tilesPerRow + (pc >> S)) * tileCells + (dilate(pr & (side - 1)) << 1) +
+               dilate(pc & (side - 1));
+    }
+    int row(long long i) const { return (i / tileRowCells) * side + undilate(i >> 1 & colBits) - pad; }
+    int col(long long i) const {
+        return (i / tileCells % tilesPerRow) * side + undilate(i & colBits) - pad;
+    }
+
+    // The cell (dr, dc) away from i.
+    template <int dr, int dc>
+    static long long step(long long i, long long tileRowCells) {
+        static_assert(dr > -side && dr < side && dc > -side && dc < side, "move longer than a tile");
+        long long x = i & colBits, y = i & rowBits, base = i - x - y;
+        long long tx = dc >= 0 ? (x | rowBits) + dilate(dc) : x - dilate(-dc);
+        long long ty = dr >= 0 ? (y | colBits) + (dilate(dr) << 1) : y - (dilate(-dr) << 1);
+        // tx >> 2S is the carry (+1) or borrow (-1) out of the tile, else 0
+        return base + (tx >> (2 * S)) * tileCells + (ty >> (2 * S)) * tileRowCells + (tx & colBits) +
+               (ty & rowBits);
+    }
+
+    T& operator[](long long i) { return cells[i]; }
+    const T& operator[](long long i) const { return cells[i]; }
+    T& operator()(int r, int c) { return cells[index(r, c)]; }
+    const T& operator()(int r, int c) const { return cells[index(r, c)]; }
+
+    // Calls f(index) for every real cell, tile by tile. Inside a tile the
+    // cells go row by row; the next dilated column is one masked add.
+    template <class F>
+    void forEachCell(F f) const {
+        for (long long tr = 0; tr < tileRows; tr++) {
+            long long r0 = tr * side - pad; // real row of the tile's first row
+            long long rlo = max(0LL, -r0), rhi = min<long long>(side, rows - r0);
+            for (long long tc = 0; tc < tilesPerRow; tc++) {
+                long long c0 = tc * side - pad;
+                long long clo = max(0LL, -c0), chi = min<long long>(side, cols - c0);
+                long long base = (tr * tilesPerRow + tc) * tileCells;
+                for (long long lr = rlo; lr < rhi; lr++) {
+                    long long rowStart = base + (dilate(lr) << 1);
+                    for (long long lc = clo, x = dilate(clo); lc < chi; lc++, x = ((x | rowBits) + 1) & colBits)
+                        f(rowStart + x);
+                }
+            }
+        }
+    }
+};
+
+template <class N, class T, int S, class F, size_t... I>
+inline bool forEachNeighbor(const TiledGrid<T, S>&, long long tileRowCells, long long cell, F& f,
+                            index_sequence<I...>) {
+    return (f(TiledGrid<T, S>::template step<N::delta[2 * I], N::delta[2 * I + 1]>(cell, tileRowCells)) || ...);
+}
+
+// gridBfs on a TiledGrid: each move is a step<dr, dc>() instead of an offset.
+template <class N, class T, int S>
+auto neighbors(const TiledGrid<T, S>& grid) {
+    return [&grid, rowCells = grid.tileRowCells](long long cell, auto&& f) {
+        return forEachNeighbor<N>(grid, rowCells, cell, f, make_index_sequence<N::size>{});
+    };
+}
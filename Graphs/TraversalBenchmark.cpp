@@ -0,0 +1,816 @@
+/*
+TraversalBenchmark — time every traversal variant in this folder on the same grids
+
+Each problem file keeps several alternatives (BFS / DFS / DSU / bitsets ...)
+and until now the only comparison was the complexity table in a comment.
+This program measures them.
+
+How it works:
+- The problem files are #included into their own namespaces (their main()
+  just becomes e.g. islands::main and is never called), so every variant is
+  called exactly as written.
+- Grid generators (all seeded, so runs are repeatable):
+    random        each cell open with probability 0.5
+    percolation   p = 0.5927, the site-percolation threshold: huge, twisty clusters
+    maze          perfect maze (randomized DFS), long corridors, one path between cells
+    spiral        one corridor winding to the centre: the deepest possible DFS
+    checkerboard  every open cell isolated: the most islands / unions possible
+- "open" means land (islands), colour 1 (flood fill), fresh orange (rotting),
+  1 (01 matrix) or walkable (maze).
+- Sizes go from --min-cells to --max-cells, ×10 each time, on square grids.
+- Every (problem, variant, generator, size) runs in a forked child process:
+  peak RSS (getrusage) then belongs to that variant alone, and a recursive DFS
+  that blows the stack is reported as "crashed" instead of killing the run.
+  Children are stopped after --timeout seconds.
+- Only the call itself is timed; building the input is not.
+- If the kernel allows it, hardware cache misses / references for the timed
+  region are read with perf_event_open (otherwise they are reported as -1).
+
+Output (CSV or JSON), one record per run:
+problem, variant, generator, rows, cols, cells, ms, ns_per_cell,
+peak_rss_kb, cache_refs, cache_misses, misses_per_cell, result, status
+`result` is the variant's answer, so rows of the same problem should agree
+(maze: the route length; the DFS variants only answer 1 = found). A maze
+run whose solver found no route has status "unreachable".
+
+Build and run:
+    g++ -O2 -std=c++17 -pthread -mavx2 TraversalBenchmark.cpp -o bench
+    ./bench --min-cells=1000 --max-cells=10000000 --format=csv
+Options: --problem=islands,floodfill,rotting,matrix,maze  --gen=random,maze,...
+         --variant=<name>  --threads=N  --seed=N  --timeout=SECONDS
+         --stats=FILE  --trace=FILE  --mode=layout
+
+Row-major vs tiled layout (--mode=layout):
+runs only bfs and bfs-tiled (TiledGrid.h) of islands, floodfill and rotting
+on percolation, maze and random grids, starting at the first size whose int
+grid is larger than the last-level cache (sysconf; override with
+--min-cells / --max-cells). After each pair a summary line on stderr gives
+the change in cache misses per cell and in time.
+
+Why is a run slow? Build with -DTRAVERSAL_STATS (TraversalStats.h) and pass
+--stats=FILE for the per-call counters (visited, enqueued, queue peak,
+relaxations, levels, per-level times) as JSON, or --trace=FILE for a Chrome
+trace (chrome://tracing, ui.perfetto.dev) with one process per run. The
+counters and per-level clocks slow the traversals down, so take times from a
+normal build.
+1e9 cells works for the flat-grid variants if the machine has the memory;
+variants built on vector<vector<...>> or recursion have their own lower caps.
+*/
+
+#include <bits/stdc++.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "BitFrontierBFS.h"
+#include "ConcurrentDSU.h"
+#include "GridFile.h"
+#include "Neighborhood.h"
+#include "TiledGrid.h"
+#include "TraversalStats.h"
+#include "TraversalWorkspace.h"
+#include "Parallel.h"
+using namespace std;
+
+namespace islands {
+#include "NumberofIslands.cpp"
+}
+namespace floodfill {
+#include "FloodFill.cpp"
+}
+namespace rotting {
+#include "RottingOranges.cpp"
+}
+namespace matrix {
+#include "01Matrix.cpp"
+}
+namespace maze {
+#include "ShortestPathinaBinaryMaze.cpp"
+}
+
+// ---------- grid generators ----------
+
+struct Mask {
+    int rows, cols;
+    vector<uint8_t> open; // row-major, 1 = open
+
+    Mask(int rows, int cols) : rows(rows), cols(cols), open((long long)rows * cols, 0) {}
+    uint8_t& at(int r, int c) { return open[(long long)r * cols + c]; }
+    uint8_t at(int r, int c) const { return open[(long long)r * cols + c]; }
+};
+
+Mask randomMask(int n, double p, uint64_t seed) {
+    Mask m(n, n);
+    mt19937_64 rng(seed);
+    for (auto& cell : m.open) cell = (rng() >> 11) * 0x1.0p-53 < p;
+    return m;
+}
+
+Mask mazeMask(int n, uint64_t seed) {
+    Mask m(n, n);
+    mt19937_64 rng(seed);
+    // rooms sit on even (r, c); carve walls between them with an iterative DFS
+    int R = (n + 1) / 2, C = (n + 1) / 2;
+    vector<int> st = {0};
+    m.at(0, 0) = 1;
+    int dr[4] = {-1, 1, 0, 0}, dc[4] = {0, 0, -1, 1};
+    while (!st.empty()) {
+        int room = st.back(), r = room / C, c = room % C;
+        int order[4] = {0, 1, 2, 3};
+        shuffle(order, order + 4, rng);
+        bool moved = false;
+        for (int d : order) {
+            int nr = r + dr[d], nc = c + dc[d];
+            if (nr < 0 || nr >= R || nc < 0 || nc >= C || m.at(2 * nr, 2 * nc)) continue;
+            m.at(r + nr, c + nc) = 1; // the wall between the two rooms
+            m.at(2 * nr, 2 * nc) = 1;
+            st.push_back(nr * C + nc);
+            moved = true;
+            break;
+        }
+        if (!moved) st.pop_back();
+    }
+    return m;
+}
+
+Mask spiralMask(int n) {
+    Mask m(n, n);
+    int top = 0, bottom = n - 1, left = 0, right = n - 1, r = 0, c = 0;
+    while (true) {
+        for (; c <= right; c++) m.at(top, c) = 1;
+        c = right, top += 2;
+        if (top > bottom) break;
+        for (; r <= bottom; r++) m.at(r, right) = 1;
+        r = bottom, right -= 2;
+        if (left > right) break;
+        for (; c >= left; c--) m.at(bottom, c) = 1;
+        c = left, bottom -= 2;
+        if (top > bottom) break;
+        for (; r >= top; r--) m.at(r, left) = 1;
+        r = top, left += 2;
+        if (left > right) break;
+    }
+    return m;
+}
+
+Mask checkerboardMask(int n) {
+    Mask m(n, n);
+    for (int r = 0; r < n; r++)
+        for (int c = 0; c < n; c++) m.at(r, c) = (r + c) % 2 == 0;
+    return m;
+}
+
+Mask makeMask(const string& gen, int n, uint64_t seed) {
+    if (gen == "random") return randomMask(n, 0.5, seed);
+    if (gen == "percolation") return randomMask(n, 0.5927, seed);
+    if (gen == "maze") return mazeMask(n, seed);
+    if (gen == "spiral") return spiralMask(n);
+    return checkerboardMask(n);
+}
+
+// ---------- converters (not timed) ----------
+
+template <class T>
+Grid<T> toGrid(const Mask& m, T open, T closed, T sentinel) {
+    Grid<T> g(m.rows, m.cols, closed, sentinel);
+    for (int r = 0; r < m.rows; r++)
+        for (int c = 0; c < m.cols; c++)
+            if (m.at(r, c)) g(r, c) = open;
+    return g;
+}
+
+template <class T>
+vector<vector<T>> toVector(const Mask& m, T open, T closed) {
+    vector<vector<T>> v(m.rows, vector<T>(m.cols, closed));
+    for (int r = 0; r < m.rows; r++)
+        for (int c = 0; c < m.cols; c++)
+            if (m.at(r, c)) v[r][c] = open;
+    return v;
+}
+
+// Opens the fewest walls needed to join the far corner (rows-1, cols-1) to
+// the open component of (0, 0), both already open: one BFS marks that
+// component, a second BFS from the corner (through walls too, but not the
+// border) stops at the first marked cell and opens the cells on its way.
+// Returns false if nothing had to be opened.
+bool connectCorners(Grid<int>& g) {
+    long long s = g.index(0, 0), t = g.index(g.rows - 1, g.cols - 1);
+    array<long long, 4> dirs = g.dirs4();
+    vector<char> reach(g.cells.size(), 0);
+    vector<long long> q = {s};
+    reach[s] = 1;
+    for (size_t h = 0; h < q.size(); h++)
+        for (long long d : dirs)
+            if (g[q[h] + d] == 1 && !reach[q[h] + d]) reach[q[h] + d] = 1, q.push_back(q[h] + d);
+    if (reach[t]) return false;
+
+    vector<long long> from(g.cells.size(), -1);
+    q = {t};
+    from[t] = t;
+    for (size_t h = 0; h < q.size(); h++) {
+        long long u = q[h];
+        if (reach[u]) {
+            for (long long x = u; x != t; x = from[x]) g[x] = 1;
+            return true;
+        }
+        for (long long d : dirs) {
+            long long x = u + d;
+            int r = g.row(x), c = g.col(x);
+            if (r < 0 || r >= g.rows || c < 0 || c >= g.cols || from[x] != -1) continue;
+            from[x] = u;
+            q.push_back(x);
+        }
+    }
+    return true; // not reached: (0, 0) is always marked
+}
+
+pair<int,int> firstOpen(const Mask& m) {
+    for (int r = 0; r < m.rows; r++)
+        for (int c = 0; c < m.cols; c++)
+            if (m.at(r, c)) return {r, c};
+    return {0, 0};
+}
+
+// ---------- timing + hardware counters ----------
+
+struct PerfCounter {
+    int fd = -1;
+    explicit PerfCounter(uint64_t config) {
+        perf_event_attr pe{};
+        pe.type = PERF_TYPE_HARDWARE;
+        pe.size = sizeof(pe);
+        pe.config = config;
+        pe.disabled = 1;
+        pe.inherit = 1; // count worker threads too
+        pe.exclude_kernel = 1;
+        pe.exclude_hv = 1;
+        fd = syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0);
+    }
+    ~PerfCounter() {
+        if (fd >= 0) close(fd);
+    }
+    void start() {
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    long long stop() {
+        if (fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long value = -1;
+        if (read(fd, &value, sizeof(value)) != sizeof(value)) return -1;
+        return value;
+    }
+};
+
+struct Timer {
+    PerfCounter refs{PERF_COUNT_HW_CACHE_REFERENCES}, misses{PERF_COUNT_HW_CACHE_MISSES};
+    chrono::steady_clock::time_point t0;
+    double ns = 0;
+    long long cacheRefs = -1, cacheMisses = -1;
+
+    void start() {
+        refs.start();
+        misses.start();
+        t0 = chrono::steady_clock::now();
+    }
+    void stop() {
+        ns = chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count();
+        cacheMisses = misses.stop();
+        cacheRefs = refs.stop();
+    }
+};
+
+// ---------- the variants ----------
+
+struct Variant {
+    string problem, name;
+    long long maxCells; // larger grids are skipped (vector<vector>, recursion, O(n²) DFS)
+    function<long long(const Mask&, Timer&)> run;
+};
+
+int threads = max(1u, thread::hardware_concurrency());
+const long long ANY = LLONG_MAX, VECTOR_CAP = 100000000, RECURSION_CAP = 1000000, SLOW_CAP = 10000;
+
+vector<Variant> variants() {
+    vector<Variant> v;
+
+    // Number of Islands
+    v.push_back({"islands", "bfs", ANY, [](const Mask& m, Timer& t) {
+        Grid<char> g = toGrid<char>(m, '1', '0', '0');
+        Grid<char> vis(g.rows, g.cols, 0, 1);
+        t.start();
+        long long count = 0;
+        for (int i = 0; i < g.rows; i++)
+            for (int j = 0; j < g.cols; j++) {
+                long long id = g.index(i, j);
+                if (g[id] == '1' && !vis[id]) count++, islands::bfs(id, g, vis);
+            }
+        t.stop();
+        return count;
+    }});
+    v.push_back({"islands", "bfs-tiled", ANY, [](const Mask& m, Timer& t) {
+        TiledGrid<char> g = TiledGrid<char>::from(toGrid<char>(m, '1', '0', '0'));
+        TiledGrid<char> vis(g.rows, g.cols, 0, 1);
+        t.start();
+        long long count = 0;
+        g.forEachCell([&](long long id) {
+            if (g[id] == '1' && !vis[id]) count++, islands::bfs(id, g, vis);
+        });
+        t.stop();
+        return count;
+    }});
+    v.push_back({"islands", "dfs-recursive", RECURSION_CAP, [](const Mask& m, Timer& t) {
+        auto g = toVector<char>(m, '1', '0');
+        vector<vector<int>> vis(m.rows, vector<int>(m.cols, 0));
+        t.start();
+        long long count = 0;
+        for (int i = 0; i < m.rows; i++)
+            for (int j = 0; j < m.cols; j++)
+                if (g[i][j] == '1' && !vis[i][j]) count++, islands::dfs(i, j, g, vis);
+        t.stop();
+        return count;
+    }});
+    v.push_back({"islands", "dfs-iterative", ANY, [](const Mask& m, Timer& t) {
+        Grid<char> g = toGrid<char>(m, '1', '0', '0');
+        Grid<char> vis(g.rows, g.cols, 0, 1);
+        t.start();
+        long long count = 0;
+        for (int i = 0; i < g.rows; i++)
+            for (int j = 0; j < g.cols; j++) {
+                long long id = g.index(i, j);
+                if (g[id] == '1' && !vis[id]) count++, islands::dfsIter(id, g, vis);
+            }
+        t.stop();
+        return count;
+    }});
+    v.push_back({"islands", "dsu", ANY, [](const Mask& m, Timer& t) {
+        Grid<char> g = toGrid<char>(m, '1', '0', '0');
+        t.start();
+        long long count = islands::numIslands(g);
+        t.stop();
+        return count;
+    }});
+    v.push_back({"islands", "bit-runs", ANY, [](const Mask& m, Timer& t) {
+        BitGrid g(m.rows, m.cols);
+        for (int r = 0; r < m.rows; r++)
+            for (int c = 0; c < m.cols; c++)
+                if (m.at(r, c)) g.set(r, c);
+        t.start();
+        long long count = islands::numIslands(g);
+        t.stop();
+        return count;
+    }});
+    v.push_back({"islands", "parallel-tiles", ANY, [](const Mask& m, Timer& t) {
+        Grid<char> g = toGrid<char>(m, '1', '0', '0');
+        t.start();
+        long long count = islands::labelIslandsParallel(g, threads).count;
+        t.stop();
+        return count;
+    }});
+    v.push_back({"islands", "parallel-dsu", ANY, [](const Mask& m, Timer& t) {
+        Grid<char> g = toGrid<char>(m, '1', '0', '0');
+        t.start();
+        long long count = islands::numIslandsParallel(g, threads);
+        t.stop();
+        return count;
+    }});
+    v.push_back({"islands", "streaming", ANY, [](const Mask& m, Timer& t) {
+        string text;
+        text.reserve((long long)m.rows * (m.cols + 1));
+        for (int r = 0; r < m.rows; r++) {
+            for (int c = 0; c < m.cols; c++) text += m.at(r, c) ? '1' : '0';
+            text += '\n';
+        }
+        istringstream in(move(text));
+        t.start();
+        long long count = islands::countIslandsStream(in).count;
+        t.stop();
+        return count;
+    }});
+    v.push_back({"islands", "online-addland", ANY, [](const Mask& m, Timer& t) {
+        islands::IslandCounter counter;
+        t.start();
+        for (int r = 0; r < m.rows; r++)
+            for (int c = 0; c < m.cols; c++)
+                if (m.at(r, c)) counter.addLand(r, c);
+        t.stop();
+        return (long long)counter.count();
+    }});
+
+    // Flood Fill (recolor the component of the first open cell from 1 to 2)
+    auto painted = [](const Grid<int>& g) {
+        long long n = 0;
+        for (int r = 0; r < g.rows; r++)
+            for (int c = 0; c < g.cols; c++) n += g(r, c) == 2;
+        return n;
+    };
+    v.push_back({"floodfill", "bfs", ANY, [=](const Mask& m, Timer& t) {
+        Grid<int> g = toGrid<int>(m, 1, 0, INT_MIN);
+        auto [sr, sc] = firstOpen(m);
+        t.start();
+        floodfill::bfsFloodFill(sr, sc, g, 2);
+        t.stop();
+        return painted(g);
+    }});
+    v.push_back({"floodfill", "bfs-tiled", ANY, [=](const Mask& m, Timer& t) {
+        TiledGrid<int> g = TiledGrid<int>::from(toGrid<int>(m, 1, 0, INT_MIN));
+        auto [sr, sc] = firstOpen(m);
+        TraversalWorkspace ws;
+        t.start();
+        floodfill::bfsFloodFill(sr, sc, g, 2, ws);
+        t.stop();
+        return painted(g.toGrid());
+    }});
+    v.push_back({"floodfill", "dfs-recursive", RECURSION_CAP, [=](const Mask& m, Timer& t) {
+        auto img = toVector<int>(m, 1, 0);
+        auto [sr, sc] = firstOpen(m);
+        t.start();
+        floodfill::dfsFloodFill(img, sr, sc, img[sr][sc], 2);
+        t.stop();
+        return painted(Grid<int>::from(img, INT_MIN));
+    }});
+    v.push_back({"floodfill", "dfs-iterative", VECTOR_CAP, [=](const Mask& m, Timer& t) {
+        auto img = toVector<int>(m, 1, 0);
+        auto [sr, sc] = firstOpen(m);
+        t.start();
+        floodfill::dfsIterativeFloodFill(img, sr, sc, 2);
+        t.stop();
+        return painted(Grid<int>::from(img, INT_MIN));
+    }});
+    v.push_back({"floodfill", "union-find", ANY, [=](const Mask& m, Timer& t) {
+        Grid<int> g = toGrid<int>(m, 1, 0, INT_MIN);
+        auto [sr, sc] = firstOpen(m);
+        t.start();
+        floodfill::unionFindFloodFill(g, sr, sc, 2);
+        t.stop();
+        return painted(g);
+    }});
+    v.push_back({"floodfill", "union-find-parallel", ANY, [=](const Mask& m, Timer& t) {
+        Grid<int> g = toGrid<int>(m, 1, 0, INT_MIN);
+        auto [sr, sc] = firstOpen(m);
+        t.start();
+        floodfill::unionFindFloodFillParallel(g, sr, sc, 2, threads);
+        t.stop();
+        return painted(g);
+    }});
+    v.push_back({"floodfill", "scanline", ANY, [=](const Mask& m, Timer& t) {
+        Grid<int> g = toGrid<int>(m, 1, 0, INT_MIN);
+        auto [sr, sc] = firstOpen(m);
+        t.start();
+        floodfill::scanlineFloodFill(sr, sc, g, 2);
+        t.stop();
+        return painted(g);
+    }});
+
+    // Rotting Oranges (open = fresh, the first open cell starts rotten)
+    auto orchard = [](const Mask& m) {
+        Grid<int> g = toGrid<int>(m, 1, 0, 0);
+        auto [r, c] = firstOpen(m);
+        g(r, c) = 2;
+        return g;
+    };
+    v.push_back({"rotting", "bfs", ANY, [=](const Mask& m, Timer& t) {
+        Grid<int> g = orchard(m);
+        t.start();
+        long long minutes = rotting::orangesRotting(g);
+        t.stop();
+        return minutes;
+    }});
+    v.push_back({"rotting", "bfs-tiled", ANY, [=](const Mask& m, Timer& t) {
+        TiledGrid<int> g = TiledGrid<int>::from(orchard(m));
+        TraversalWorkspace ws;
+        t.start();
+        long long minutes = rotting::orangesRotting(g, ws);
+        t.stop();
+        return minutes;
+    }});
+    v.push_back({"rotting", "dfs-recursive", SLOW_CAP, [=](const Mask& m, Timer& t) {
+        auto g = orchard(m).toVector();
+        t.start();
+        long long minutes = rotting::orangesRottingDfs(g);
+        t.stop();
+        return minutes;
+    }});
+    v.push_back({"rotting", "dfs-iterative", SLOW_CAP, [=](const Mask& m, Timer& t) {
+        auto g = orchard(m).toVector();
+        t.start();
+        long long minutes = rotting::orangesRottingDfsIter(g);
+        t.stop();
+        return minutes;
+    }});
+    v.push_back({"rotting", "bitset-frontier", ANY, [=](const Mask& m, Timer& t) {
+        Grid<int> g = orchard(m);
+        t.start();
+        long long minutes = rotting::orangesRottingBitset(g);
+        t.stop();
+        return minutes;
+    }});
+    v.push_back({"rotting", "bitplane", ANY, [=](const Mask& m, Timer& t) {
+        Grid<int> g = orchard(m);
+        t.start();
+        long long minutes = rotting::orangesRottingBitplane(g);
+        t.stop();
+        return minutes;
+    }});
+    v.push_back({"rotting", "incremental-build", ANY, [=](const Mask& m, Timer& t) {
+        Grid<int> g = orchard(m);
+        t.start();
+        long long minutes = rotting::RottingSimulation(g).status().minutes();
+        t.stop();
+        return minutes;
+    }});
+
+    // 01 Matrix (open = 1, closed = 0); result = largest distance
+    auto largest = [](const auto& g) {
+        long long best = 0;
+        for (int r = 0; r < g.rows; r++)
+            for (int c = 0; c < g.cols; c++) best = max(best, (long long)g(r, c));
+        return best;
+    };
+    v.push_back({"matrix", "bfs", ANY, [=](const Mask& m, Timer& t) {
+        Grid<int> g = toGrid<int>(m, 1, 0, 0);
+        t.start();
+        Grid<int> d = matrix::Solution().updateMatrix(g);
+        t.stop();
+        return largest(d);
+    }});
+    v.push_back({"matrix", "manhattan-transform", ANY, [=](const Mask& m, Timer& t) {
+        Grid<int> g = toGrid<int>(m, 1, 0, 0);
+        t.start();
+        Grid<int> d = matrix::manhattanDistanceTransform(g, threads);
+        t.stop();
+        return largest(d);
+    }});
+    v.push_back({"matrix", "euclidean-transform", ANY, [=](const Mask& m, Timer& t) {
+        Grid<int> g = toGrid<int>(m, 1, 0, 0);
+        t.start();
+        Grid<double> d = matrix::euclideanDistanceTransform(g, threads);
+        t.stop();
+        return largest(d);
+    }});
+    v.push_back({"matrix", "bitset-frontier", ANY, [=](const Mask& m, Timer& t) {
+        Grid<int> g = toGrid<int>(m, 1, 0, 0);
+        t.start();
+        Grid<int> d = matrix::updateMatrixBitset(g);
+        t.stop();
+        return largest(d);
+    }});
+
+    // Shortest path in a binary maze, corner to corner. Both corners are
+    // forced open and joined by connectCorners (setup, not timed): with an
+    // even n the maze generator never carves (n-1, n-1), and a random grid
+    // rarely links its corners, so otherwise most runs would just time a -1.
+    // Every solver returns -1 for "no route", reported as "unreachable".
+    auto walls = [](const Mask& m) {
+        Grid<int> g = toGrid<int>(m, 1, 0, 0);
+        g(0, 0) = g(m.rows - 1, m.cols - 1) = 1;
+        connectCorners(g);
+        return g;
+    };
+    auto corner = [](const Mask& m) { return make_pair(m.rows - 1, m.cols - 1); };
+    v.push_back({"maze", "bfs", ANY, [=](const Mask& m, Timer& t) {
+        Grid<int> g = walls(m);
+        Grid<int> dist(g.rows, g.cols, -1, -1);
+        t.start();
+        maze::bfs(g, {0, 0}, corner(m), dist);
+        t.stop();
+        return (long long)dist(m.rows - 1, m.cols - 1);
+    }});
+    v.push_back({"maze", "bfs-route", ANY, [=](const Mask& m, Timer& t) {
+        Grid<int> g = walls(m);
+        t.start();
+        maze::MazeRoute route = maze::bfsRoute(g, {0, 0}, corner(m));
+        t.stop();
+        return (long long)route.dist;
+    }});
+    v.push_back({"maze", "dfs-recursive", RECURSION_CAP, [=](const Mask& m, Timer& t) {
+        auto g = walls(m).toVector();
+        vector<vector<bool>> vis(m.rows, vector<bool>(m.cols, false));
+        t.start();
+        long long found = maze::dfsRec(g, vis, 0, 0, m.rows - 1, m.cols - 1);
+        t.stop();
+        return found ? 1 : -1;
+    }});
+    v.push_back({"maze", "dfs-iterative", VECTOR_CAP, [=](const Mask& m, Timer& t) {
+        auto g = walls(m).toVector();
+        t.start();
+        long long found = maze::dfsIter(g, {0, 0}, corner(m));
+        t.stop();
+        return found ? 1 : -1;
+    }});
+    v.push_back({"maze", "bidirectional", ANY, [=](const Mask& m, Timer& t) {
+        Grid<int> g = walls(m);
+        t.start();
+        long long d = maze::bidirectionalBfs(g, {0, 0}, corner(m)).dist;
+        t.stop();
+        return d;
+    }});
+    v.push_back({"maze", "astar", ANY, [=](const Mask& m, Timer& t) {
+        Grid<int> g = walls(m);
+        t.start();
+        long long d = maze::aStar(g, {0, 0}, corner(m)).dist;
+        t.stop();
+        return d;
+    }});
+    v.push_back({"maze", "jump-point", ANY, [=](const Mask& m, Timer& t) {
+        Grid<int> g = walls(m);
+        t.start();
+        long long d = maze::jumpPointSearch(g, {0, 0}, corner(m)).dist;
+        t.stop();
+        return d;
+    }});
+    return v;
+}
+
+// ---------- instrumentation export (counters need -DTRAVERSAL_STATS) ----------
+
+string statsPath, tracePath;
+const string statsOpen = "[\n", traceOpen = "{\"traceEvents\":[\n";
+
+// Called in the child after its run: appends the run's records to the files
+// main() opened. Children run one after another, so a file that still holds
+// only its opening bracket gets no leading comma.
+void appendStats(const string& problem, const string& name, const string& gen, int n) {
+    vector<TraversalStats> calls = takeTraversalStats();
+    string label = problem + "/" + name + "/" + gen + "/" + to_string((long long)n * n);
+    if (!statsPath.empty()) {
+        bool first = filesystem::file_size(statsPath) == statsOpen.size();
+        ofstream out(statsPath, ios::app);
+        out << (first ? "" : ",\n") << "{\"problem\":\"" << problem << "\",\"variant\":\"" << name
+            << "\",\"generator\":\"" << gen << "\",\"cells\":" << (long long)n * n << ",\"calls\":";
+        writeStatsJson(out, calls);
+        out << '}';
+    }
+    if (!tracePath.empty()) {
+        bool first = filesystem::file_size(tracePath) == traceOpen.size();
+        ofstream out(tracePath, ios::app);
+        out << (first ? "" : ",\n") << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << getpid()
+            << ",\"args\":{\"name\":\"" << label << "\"}}";
+        first = false;
+        writeTraceEvents(out, calls, first);
+    }
+}
+
+// ---------- one measurement in a child process ----------
+
+struct Record {
+    double ns = 0;
+    long long peakRssKb = -1, cacheRefs = -1, cacheMisses = -1, result = 0;
+};
+
+string measure(const Variant& var, const string& gen, int n, uint64_t seed, int timeout, Record& rec) {
+    int fds[2];
+    if (pipe(fds) != 0) return "error";
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        alarm(timeout);
+        Mask m = makeMask(gen, n, seed);
+        Timer t;
+        Record out;
+        {
+            STAT_SCOPE(var.name.c_str()); // every traversal call of the run adds to one record
+            out.result = var.run(m, t);
+        }
+        appendStats(var.problem, var.name, gen, n);
+        out.ns = t.ns;
+        out.cacheRefs = t.cacheRefs;
+        out.cacheMisses = t.cacheMisses;
+        rusage ru;
+        getrusage(RUSAGE_SELF, &ru);
+        out.peakRssKb = ru.ru_maxrss;
+        ssize_t written = write(fds[1], &out, sizeof(out));
+        _exit(written == sizeof(out) ? 0 : 1);
+    }
+    close(fds[1]);
+    int status = 0;
+    bool got = read(fds[0], &rec, sizeof(rec)) == sizeof(rec);
+    close(fds[0]);
+    waitpid(pid, &status, 0);
+    if (WIFSIGNALED(status)) return WTERMSIG(status) == SIGALRM ? "timeout" : "crashed";
+    return got ? "ok" : "error";
+}
+
+// ---------- main ----------
+
+long long lastLevelCacheBytes() {
+    long long bytes = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (bytes <= 0) bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    return bytes > 0 ? bytes : 32LL << 20;
+}
+
+set<string> splitList(const string& s) {
+    set<string> out;
+    stringstream ss(s);
+    for (string item; getline(ss, item, ',');)
+        if (!item.empty()) out.insert(item);
+    return out;
+}
+
+int main(int argc, char** argv) {
+    map<string, string> opt = {
+        {"min-cells", "1000"}, {"max-cells", "10000000"}, {"format", "csv"}, {"seed", "12345"},
+        {"timeout", "120"}, {"problem", ""}, {"gen", "random,percolation,maze,spiral,checkerboard"},
+        {"variant", ""}, {"threads", to_string(threads)}, {"stats", ""}, {"trace", ""}, {"mode", ""}};
+    set<string> given;
+    for (int i = 1; i < argc; i++) {
+        string a = argv[i];
+        size_t eq = a.find('=');
+        if (a.rfind("--", 0) != 0 || eq == string::npos) {
+            cerr << "usage: " << argv[0] << " [--key=value ...]\n";
+            return 1;
+        }
+        opt[a.substr(2, eq - 2)] = a.substr(eq + 1);
+        given.insert(a.substr(2, eq - 2));
+    }
+    bool layoutMode = opt["mode"] == "layout";
+    if (layoutMode) {
+        long long cells = 1000;
+        while (cells * (long long)sizeof(int) <= lastLevelCacheBytes()) cells *= 10;
+        if (!given.count("min-cells")) opt["min-cells"] = to_string(cells);
+        if (!given.count("max-cells")) opt["max-cells"] = opt["min-cells"];
+        if (!given.count("problem")) opt["problem"] = "islands,floodfill,rotting";
+        if (!given.count("gen")) opt["gen"] = "percolation,maze,random";
+        if (!given.count("variant")) opt["variant"] = "bfs,bfs-tiled";
+    }
+    long long minCells = stod(opt["min-cells"]), maxCells = stod(opt["max-cells"]);
+    uint64_t seed = stoull(opt["seed"]);
+    int timeout = stoi(opt["timeout"]);
+    threads = max(1, stoi(opt["threads"]));
+    bool json = opt["format"] == "json";
+    statsPath = opt["stats"], tracePath = opt["trace"];
+    if (!statsPath.empty()) ofstream(statsPath) << statsOpen;
+    if (!tracePath.empty()) ofstream(tracePath) << traceOpen;
+#ifndef TRAVERSAL_STATS
+    if (!statsPath.empty() || !tracePath.empty())
+        cerr << "note: built without -DTRAVERSAL_STATS, no counters will be recorded\n";
+#endif
+    set<string> problems = splitList(opt["problem"]), gens = splitList(opt["gen"]),
+                names = splitList(opt["variant"]);
+
+    if (json) cout << "[\n";
+    else
+        cout << "problem,variant,generator,rows,cols,cells,ms,ns_per_cell,peak_rss_kb,"
+                "cache_refs,cache_misses,misses_per_cell,result,status\n";
+    bool first = true;
+    map<string, Record> rowMajor; // layout mode: the "bfs" run of each (problem, generator, size)
+
+    for (long long cells = minCells; cells <= maxCells; cells *= 10) {
+        int n = max(2LL, llround(sqrt((double)cells)));
+        long long real = (long long)n * n;
+        for (const string& gen : gens) {
+            for (const Variant& var : variants()) {
+                if (!problems.empty() && !problems.count(var.problem)) continue;
+                if (!names.empty() && !names.count(var.name)) continue;
+                if (real > var.maxCells) continue;
+
+                Record rec;
+                string status = measure(var, gen, n, seed, timeout, rec);
+                if (status == "ok" && var.problem == "maze" && rec.result == -1) status = "unreachable";
+                double missesPerCell = rec.cacheMisses < 0 ? -1 : (double)rec.cacheMisses / real;
+                if (json) {
+                    cout << (first ? "" : ",\n") << "  {\"problem\":\"" << var.problem << "\",\"variant\":\""
+                         << var.name << "\",\"generator\":\"" << gen << "\",\"rows\":" << n << ",\"cols\":" << n
+                         << ",\"cells\":" << real << ",\"ms\":" << rec.ns / 1e6
+                         << ",\"ns_per_cell\":" << rec.ns / real << ",\"peak_rss_kb\":" << rec.peakRssKb
+                         << ",\"cache_refs\":" << rec.cacheRefs << ",\"cache_misses\":" << rec.cacheMisses
+                         << ",\"misses_per_cell\":" << missesPerCell << ",\"result\":" << rec.result
+                         << ",\"status\":\"" << status << "\"}";
+                } else {
+                    cout << var.problem << ',' << var.name << ',' << gen << ',' << n << ',' << n << ','
+                         << real << ',' << rec.ns / 1e6 << ',' << rec.ns / real << ',' << rec.peakRssKb << ','
+                         << rec.cacheRefs << ',' << rec.cacheMisses << ',' << missesPerCell << ','
+                         << rec.result << ',' << status << '\n';
+                }
+                cout.flush();
+                first = false;
+
+                string key = var.problem + " " + gen + " " + to_string(real);
+                if (layoutMode && status == "ok" && var.name == "bfs") rowMajor[key] = rec;
+                if (layoutMode && status == "ok" && var.name == "bfs-tiled" && rowMajor.count(key)) {
+                    const Record& rm = rowMajor[key];
+                    auto change = [](double before, double after) {
+                        return before > 0 ? to_string(llround(100 * (after - before) / before)) + "%" : string("n/a");
+                    };
+                    cerr << "layout " << key << " cells: misses/cell ";
+                    if (rm.cacheMisses < 0 || rec.cacheMisses < 0)
+                        cerr << "n/a (no counters)";
+                    else
+                        cerr << (double)rm.cacheMisses / real << " -> " << (double)rec.cacheMisses / real << " ("
+                             << change(rm.cacheMisses, rec.cacheMisses) << ")";
+                    cerr << ", ms " << rm.ns / 1e6 << " -> " << rec.ns / 1e6 << " (" << change(rm.ns, rec.ns) << ")\n";
+                }
+            }
+        }
+    }
+    if (json) cout << "\n]\n";
+    if (!statsPath.empty()) ofstream(statsPath, ios::app) << "\n]\n";
+    if (!tracePath.empty()) ofstream(tracePath, ios::app) << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    return 0;
+}
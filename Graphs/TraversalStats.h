@@ -0,0 +1,226 @@
+#pragma once
+#include <bits/stdc++.h>
+#include <unistd.h>
+using namespace std;
+
+/*
+TraversalStats — opt-in counters and per-level timings for every traversal
+
+A slow orangesRotting or maze bfs call says nothing about WHY it was slow.
+With instrumentation on, every traversal call records:
+    visited       cells taken out of the queue / stack / heap (expanded)
+    enqueued      pushes, sources included
+    queuePeak     most entries waiting in the queue / stack / heap at once
+    relaxations   distance updates that went through a comparison
+                  (a better meeting point or g in the maze searches)
+    levels        BFS levels (one level = one minute / one step)
+plus the wall time of the call and of each level (the first maxLevelTimes
+levels; later levels are still counted in `levels`).
+
+Switching it on and off:
+    g++ -DTRAVERSAL_STATS ...   the STAT_* macros collect
+    (default)                   every STAT_* macro expands to nothing, so the
+                                traversals compile to exactly the same code
+                                as without instrumentation
+The export functions below exist in both builds (without the flag they just
+write empty lists), so drivers and the benchmark need no #ifdef.
+
+How a call is recorded:
+- STAT_SCOPE("name") at the top of a routine opens a record for this thread.
+  If a record is already open (numIslands calling bfs once per island), the
+  inner scope adds to the outer one, so one top-level call = one record.
+- The other macros add to the open record; with no open record they do nothing.
+- When the outermost scope ends, the record goes into a global list
+  (mutex-protected, so worker threads may record their own calls).
+
+Export:
+    writeStatsJson(out)     [{"routine": ..., "visited": ..., "level_us": [...]}, ...]
+    writeChromeTrace(out)   {"traceEvents": [...]} — open in chrome://tracing
+                            or ui.perfetto.dev: one bar per call with the
+                            counters as arguments, one nested bar per level.
+    writeTraceEvents(out, first)  just the events, for appending to a
+                            trace array that someone else opened.
+*/
+
+struct TraversalStats {
+    static constexpr size_t maxLevelTimes = 1 << 16;
+
+    const char* routine = "";
+    int thread = 0;
+    double startUs = 0, totalUs = 0; // start: since the first record of this process
+    long long visited = 0, enqueued = 0, queuePeak = 0, relaxations = 0;
+    int levels = 0;
+    vector<double> levelStartUs, levelUs; // relative to startUs
+    vector<long long> levelCells;         // cells visited in that level
+
+    // for the level that is currently open
+    bool inLevel = false;
+    double levelMarkUs = 0;
+    long long levelMarkVisited = 0;
+};
+
+class StatsProbe {
+public:
+    explicit StatsProbe(const char* routine) {
+        if (current()) return; // nested call: count into the outer record
+        owner = true;
+        current() = &stats;
+        stats.routine = routine;
+        stats.thread = threadNumber();
+        stats.startUs = nowUs();
+    }
+    ~StatsProbe() {
+        if (!owner) return;
+        endLevel();
+        stats.totalUs = nowUs() - stats.startUs;
+        current() = nullptr;
+        lock_guard<mutex> lock(logMutex());
+        log().push_back(move(stats));
+    }
+    StatsProbe(const StatsProbe&) = delete;
+    StatsProbe& operator=(const StatsProbe&) = delete;
+
+    static void visit(long long n) {
+        if (TraversalStats* s = current()) s->visited += n;
+    }
+    static void enqueue(long long n, long long waiting) {
+        if (TraversalStats* s = current()) {
+            s->enqueued += n;
+            s->queuePeak = max(s->queuePeak, waiting);
+        }
+    }
+    static void relax() {
+        if (TraversalStats* s = current()) s->relaxations++;
+    }
+    // Closes the open level (if any) and opens the next one.
+    static void level() {
+        TraversalStats* s = current();
+        if (!s) return;
+        endLevel();
+        s->levels++;
+        s->inLevel = true;
+        s->levelMarkUs = nowUs();
+        s->levelMarkVisited = s->visited;
+    }
+    static void endLevel() {
+        TraversalStats* s = current();
+        if (!s || !s->inLevel) return;
+        s->inLevel = false;
+        if (s->levelUs.size() >= TraversalStats::maxLevelTimes) return;
+        s->levelStartUs.push_back(s->levelMarkUs - s->startUs);
+        s->levelUs.push_back(nowUs() - s->levelMarkUs);
+        s->levelCells.push_back(s->visited - s->levelMarkVisited);
+    }
+
+    static vector<TraversalStats>& log() {
+        static vector<TraversalStats> records;
+        return records;
+    }
+    static mutex& logMutex() {
+        static mutex m;
+        return m;
+    }
+
+private:
+    TraversalStats stats;
+    bool owner = false;
+
+    static TraversalStats*& current() {
+        thread_local TraversalStats* open = nullptr;
+        return open;
+    }
+    static double nowUs() {
+        static const chrono::steady_clock::time_point origin = chrono::steady_clock::now();
+        return chrono::duration<double, micro>(chrono::steady_clock::now() - origin).count();
+    }
+    static int threadNumber() {
+        static atomic<int> next{0};
+        thread_local int id = next++;
+        return id;
+    }
+};
+
+#ifdef TRAVERSAL_STATS
+#define STAT_SCOPE(routine) StatsProbe statsProbe_(routine)
+#define STAT_VISIT(n) StatsProbe::visit(n)
+#define STAT_ENQUEUE(n, waiting) StatsProbe::enqueue(n, (long long)(waiting))
+#define STAT_RELAX() StatsProbe::relax()
+#define STAT_LEVEL() StatsProbe::level()
+#define STAT_LEVEL_END() StatsProbe::endLevel()
+#else
+#define STAT_SCOPE(routine) ((void)0)
+#define STAT_VISIT(n) ((void)0)
+#define STAT_ENQUEUE(n, waiting) ((void)0)
+#define STAT_RELAX() ((void)0)
+#define STAT_LEVEL() ((void)0)
+#define STAT_LEVEL_END() ((void)0)
+#endif
+
+// Takes every finished record out of the global list.
+inline vector<TraversalStats> takeTraversalStats() {
+    lock_guard<mutex> lock(StatsProbe::logMutex());
+    vector<TraversalStats> out;
+    swap(out, StatsProbe::log());
+    return out;
+}
+
+// Times are written in fixed point (microseconds, 3 decimals) through a
+// private buffer, so the caller's stream formatting is left alone.
+inline void writeStatsJson(ostream& dest, const vector<TraversalStats>& calls) {
+    ostringstream out;
+    out << fixed << setprecision(3);
+    auto list = [&](const auto& v) {
+        out << '[';
+        for (size_t i = 0; i < v.size(); i++) out << (i ? "," : "") << v[i];
+        out << ']';
+    };
+    out << "[\n";
+    for (size_t i = 0; i < calls.size(); i++) {
+        const TraversalStats& s = calls[i];
+        out << (i ? ",\n" : "") << "  {\"routine\":\"" << s.routine << "\",\"thread\":" << s.thread
+            << ",\"start_us\":" << s.startUs << ",\"total_us\":" << s.totalUs << ",\"visited\":" << s.visited
+            << ",\"enqueued\":" << s.enqueued << ",\"queue_peak\":" << s.queuePeak
+            << ",\"relaxations\":" << s.relaxations << ",\"levels\":" << s.levels << ",\"level_us\":";
+        list(s.levelUs);
+        out << ",\"level_cells\":";
+        list(s.levelCells);
+        out << '}';
+    }
+    out << "\n]\n";
+    dest << out.str();
+}
+
+// Chrome trace "complete" events (ph = X). `first` is true until the first
+// event has been written, so several calls can append to one array.
+inline void writeTraceEvents(ostream& dest, const vector<TraversalStats>& calls, bool& first) {
+    ostringstream out;
+    out << fixed << setprecision(3);
+    int pid = getpid();
+    auto event = [&](const string& name, const char* cat, int tid, double ts, double dur) {
+        out << (first ? "" : ",\n") << "{\"name\":\"" << name << "\",\"cat\":\"" << cat
+            << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << tid << ",\"ts\":" << ts
+            << ",\"dur\":" << dur << ",\"args\":{";
+        first = false;
+    };
+    for (const TraversalStats& s : calls) {
+        event(s.routine, "traversal", s.thread, s.startUs, s.totalUs);
+        out << "\"visited\":" << s.visited << ",\"enqueued\":" << s.enqueued << ",\"queue_peak\":" << s.queuePeak
+            << ",\"relaxations\":" << s.relaxations << ",\"levels\":" << s.levels << "}}";
+        for (size_t k = 0; k < s.levelUs.size(); k++) {
+            event("level " + to_string(k + 1), "level", s.thread, s.startUs + s.levelStartUs[k], s.levelUs[k]);
+            out << "\"cells\":" << s.levelCells[k] << "}}";
+        }
+    }
+    dest << out.str();
+}
+
+inline void writeChromeTrace(ostream& out, const vector<TraversalStats>& calls) {
+    bool first = true;
+    out << "{\"traceEvents\":[\n";
+    writeTraceEvents(out, calls, first);
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+// The same, draining the global list.
+inline void writeStatsJson(ostream& out) { writeStatsJson(out, takeTraversalStats()); }
+inline void writeChromeTrace(ostream& out) { writeChromeTrace(out, takeTraversalStats()); }
@@ -0,0 +1,199 @@
+#pragma once
+#include "Grid.h"
+
+/*
+TraversalWorkspace — scratch memory that is reused from query to query
+
+Each traversal needs a queue or stack, a visited array and often a distance
+array. Allocating them per call is fine for one query, but when the same
+grid is queried thousands of times a second the allocations (and the
+O(cells) clearing of vis / dist) cost more than the search itself.
+
+A TraversalWorkspace owns all of that scratch memory:
+- fifo / lifo / fronts / heap keep their capacity when cleared, so after the
+  first few queries pushing never allocates again. fifo is a FrontierQueue
+  of 32-bit cell indices; frontier() hands out the 64-bit wideFifo instead
+  when a grid has 2^32 cells or more.
+- seen, distA, distB, parent, reached are epoch-stamped: every cell stores the number
+  of the query ("epoch") that last wrote it. reset() just increments the
+  epoch, so every cell instantly reads as unvisited — no memset. Only when
+  the 32-bit counter wraps (every ~4e9 resets) are the stamps really zeroed.
+  Arrays grow when a bigger grid shows up and are never shrunk.
+
+Every routine that accepts a workspace resets the parts it uses itself; the
+old signatures just create a temporary workspace. A workspace must not be
+shared by two threads at the same time (use one per thread).
+*/
+
+/*
+FrontierQueue<Index> — the BFS queue: a ring buffer of packed cell indices
+
+queue<long long> is a deque: it allocates a new 512-byte chunk every 64
+pushes, frees it again once popped, and spends 8 bytes per entry. A BFS
+frontier is just cell indices, and every traversal here marks a cell when
+it is PUSHED (push-once), so a cell is never queued twice and at most
+`cells` entries are ever waiting. That makes a much simpler queue enough:
+- entries are Index = uint32_t (4 bytes) whenever the grid has fewer than
+  2^32 cells, uint64_t only for bigger ones — withFrontier() picks;
+- one power-of-two ring buffer, head / tail wrap with a mask;
+- the buffer doubles when it is full. Under push-once that can only happen
+  while the capacity is below `cells`, so it is bounded by the cell count,
+  and a queue kept in a TraversalWorkspace stops growing after the first
+  few queries. The buffer is never zero-filled, so pages that are never
+  pushed to are never touched;
+- ahead(k) reads the entry k places behind the front, so gridBfs can
+  prefetch the neighbours of cells it will expand soon.
+*/
+template <class Index>
+class FrontierQueue {
+public:
+    static constexpr unsigned long long maxCells = (unsigned long long)numeric_limits<Index>::max();
+
+    void push(long long cell) {
+        if (tail - head == capacity) grow();
+        buf[tail++ & mask] = (Index)cell;
+    }
+    long long front() const { return buf[head & mask]; }
+    long long ahead(size_t k) const { return buf[(head + k) & mask]; } // k < size()
+    void pop() { head++; }
+    bool empty() const { return head == tail; }
+    size_t size() const { return tail - head; }
+    void clear() { head = tail = 0; }
+
+private:
+    unique_ptr<Index[]> buf;
+    size_t capacity = 0, mask = 0, head = 0, tail = 0;
+
+    void grow() {
+        size_t bigger = capacity ? 2 * capacity : 256;
+        unique_ptr<Index[]> moved(new Index[bigger]); // left uninitialised on purpose
+        for (size_t i = head; i != tail; i++) moved[i - head] = buf[i & mask];
+        tail -= head, head = 0;
+        buf = move(moved);
+        capacity = bigger, mask = bigger - 1;
+    }
+};
+
+// Calls f(q) with an empty local FrontierQueue whose entries are just wide
+// enough for the indices of a grid with `cells` cells, and returns f's result.
+template <class F>
+decltype(auto) withFrontier(size_t cells, F f) {
+    if (cells <= FrontierQueue<uint32_t>::maxCells) {
+        FrontierQueue<uint32_t> q;
+        return f(q);
+    }
+    FrontierQueue<uint64_t> q;
+    return f(q);
+}
+
+// A set of cell indices in [0, n) that is emptied in O(1).
+class EpochSet {
+public:
+    void reset(size_t n) {
+        if (stamp.size() < n) stamp.resize(n, 0);
+        if (++epoch == 0) { // wrapped around: stale stamps could match again
+            fill(stamp.begin(), stamp.end(), 0);
+            epoch = 1;
+        }
+    }
+    bool contains(long long i) const { return stamp[i] == epoch; }
+    void insert(long long i) { stamp[i] = epoch; }
+
+private:
+    vector<uint32_t> stamp;
+    uint32_t epoch = 0;
+};
+
+// A set of cell indices in [0, n) at 1 bit per cell that is emptied in
+// O(1): each 64-cell word carries an epoch stamp (an EpochSet over words), and
+// a word with a stale stamp reads as all zeros. 1.5 bits per cell in total.
+class EpochBits {
+public:
+    void reset(size_t n) {
+        size_t w = (n + 63) / 64;
+        fresh.reset(w);
+        if (words.size() < w) words.resize(w);
+    }
+    bool contains(long long i) const { return fresh.contains(i >> 6) && (words[i >> 6] >> (i & 63) & 1); }
+    void insert(long long i) {
+        long long w = i >> 6;
+        if (!fresh.contains(w)) {
+            fresh.insert(w);
+            words[w] = 0;
+        }
+        words[w] |= 1ULL << (i & 63);
+    }
+
+private:
+    EpochSet fresh;
+    vector<uint64_t> words;
+};
+
+// n values of Bits bits each, 64 / Bits per word (no value spans two words),
+// kept in `words`, which grows to fit but is never cleared: the caller sets
+// a value before it reads it (e.g. only for cells in an EpochBits set).
+template <int Bits>
+class PackedCodes {
+public:
+    static constexpr int perWord = 64 / Bits;
+    static constexpr uint64_t mask = (1ULL << Bits) - 1;
+
+    PackedCodes(vector<uint64_t>& words, size_t n) : words(words) {
+        size_t need = (n + perWord - 1) / perWord;
+        if (words.size() < need) words.resize(need);
+    }
+    unsigned get(size_t i) const { return words[i / perWord] >> (i % perWord * Bits) & mask; }
+    void set(size_t i, unsigned v) {
+        int shift = i % perWord * Bits;
+        uint64_t& w = words[i / perWord];
+        w = (w & ~(mask << shift)) | (uint64_t)v << shift;
+    }
+
+private:
+    vector<uint64_t>& words;
+};
+
+// Per-cell values that all read as `fallback` again after reset().
+template <class T>
+class EpochArray {
+public:
+    void reset(size_t n, T fallback) {
+        written.reset(n);
+        if (value.size() < n) value.resize(n);
+        this->fallback = fallback;
+    }
+    T operator[](long long i) const { return written.contains(i) ? value[i] : fallback; }
+    void set(long long i, T v) {
+        written.insert(i);
+        value[i] = v;
+    }
+
+private:
+    EpochSet written;
+    vector<T> value;
+    T fallback{};
+};
+
+struct TraversalWorkspace {
+    FrontierQueue<uint32_t> fifo;     // cell indices below 2^32
+    FrontierQueue<uint64_t> wideFifo; // the rest
+    vector<long long> lifo, frontA, frontB, next;
+    vector<tuple<int, int, long long>> heap; // (f, -g, cell) for A*-style searches, min-heap via greater<>
+    EpochSet seen;
+    EpochArray<int> distA, distB;
+    EpochArray<long long> parent;
+    EpochBits reached;      // bfsRoute: visited cells, 1 bit each
+    vector<uint64_t> moves; // bfsRoute: PackedCodes storage, 2-3 bits per cell
+
+    // withFrontier() on this workspace's (already grown) queues: f gets fifo
+    // or wideFifo, emptied.
+    template <class F>
+    decltype(auto) frontier(size_t cells, F f) {
+        if (cells <= FrontierQueue<uint32_t>::maxCells) {
+            fifo.clear();
+            return f(fifo);
+        }
+        wideFifo.clear();
+        return f(wideFifo);
+    }
+};